@@ -0,0 +1,371 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+/**
+ * @brief	Multi-telegram channel mixer for TS-UNB radio bursts (host only)
+ *
+ * @file	ChannelMixer.h
+ *
+ */
+
+
+#ifndef TSUNB_HOST_CHANNEL_MIXER_H_
+#define TSUNB_HOST_CHANNEL_MIXER_H_
+
+#ifdef __AVR_ARCH__
+#error "The channel mixer is intended for host systems only"
+#endif
+
+#include <stdint.h>
+#include <list>
+#include <thread>
+#include <vector>
+
+#include "MskModulator.h"
+
+namespace TsUnbLib {
+namespace Host {
+
+
+/**
+ * @brief Mixer of many TS-UNB telegrams into one complex baseband signal
+ *
+ * This template class sums the MSK modulated radio bursts of many telegrams, e.g. of thousands
+ * of simulated nodes, into one wideband capture for gateway capacity tests. Each telegram has
+ * its own start time, frequency offset and gain.
+ *
+ * The signal is generated block by block with mixBlock(). The caller adds all telegrams that
+ * start within the next block using addTelegram() before mixing it, or encodes and adds up to
+ * 64 telegrams with identical MPDU length at once using addTelegrams(). Telegrams are removed as
+ * soon as their last radio burst has been mixed, so the memory only depends on the number of
+ * simultaneously active telegrams and on the block size, not on the total duration.
+ * Each block is split into consecutive slices that are mixed by separate threads. The result
+ * does not depend on the number of threads.
+ *
+ * The template parameter RadioBurst_T is the radio burst class used by the PHY.
+ *
+ */
+template <class RadioBurst_T>
+class ChannelMixer {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param	samplesPerSymbol_	Oversampling factor, i.e. the sample rate is samplesPerSymbol_ * symbol rate
+	 * @param	blockSamples_		Number of complex samples per block
+	 * @param	numThreads			Number of threads for the mixing, 0 for the number of cores
+	 * @param	gaussianBT			Bandwidth-time product of the Gaussian filter, 0 for plain MSK
+	 */
+	ChannelMixer(const uint16_t samplesPerSymbol_ = 64, const uint32_t blockSamples_ = 1u << 18,
+			uint16_t numThreads = 0, const double gaussianBT = 0.0) :
+			samplesPerSymbol(samplesPerSymbol_ > 0 ? samplesPerSymbol_ : 1), blockSamples(blockSamples_ > 0 ? blockSamples_ : 1),
+			position(0), block(2 * (size_t)blockSamples) {
+
+		if (numThreads == 0)
+			numThreads = (uint16_t)std::thread::hardware_concurrency();
+		if (numThreads == 0)
+			numThreads = 1;
+
+		Modulators.reserve(numThreads);
+		for (uint16_t i = 0; i < numThreads; ++i) {
+			Modulators.push_back(MskModulator<RadioBurst_T>(samplesPerSymbol, gaussianBT));
+		}
+	}
+
+	/**
+	 * @brief	Get the sample rate
+	 *
+	 * @return	Sample rate in samples/s
+	 */
+	double getSampleRate() const {
+		return Modulators[0].getSampleRate();
+	}
+
+	/**
+	 * @brief	Get the position of the next block
+	 *
+	 * @return	Index of the first sample of the next block
+	 */
+	uint64_t getPosition() const {
+		return position;
+	}
+
+	/**
+	 * @brief	Get the number of complex samples per block
+	 *
+	 * @return	Number of complex samples per block
+	 */
+	uint32_t getBlockSamples() const {
+		return blockSamples;
+	}
+
+	/**
+	 * @brief	Get the number of telegrams that have not been mixed completely
+	 *
+	 * @return	Number of active telegrams
+	 */
+	uint32_t getNumActiveTelegrams() const {
+		return (uint32_t)Telegrams.size();
+	}
+
+	/**
+	 * @brief	Add a telegram
+	 *
+	 * The radio bursts are copied. Parts of the telegram before getPosition() are lost.
+	 *
+	 * @param	Bursts			Radio bursts of the telegram
+	 * @param	numBursts		Number of radio bursts
+	 * @param	startSample		Index of the first sample of the first radio burst
+	 * @param	freqOffset		Frequency of f_0 of the telegram relative to the center of the capture in Hz
+	 * @param	gain			Amplitude of the telegram
+	 */
+	void addTelegram(const RadioBurst_T* const Bursts, const uint16_t numBursts, const uint64_t startSample,
+			const double freqOffset, const float gain) {
+		if (numBursts == 0)
+			return;
+
+		Telegrams.push_back(Telegram());
+		Telegram& T = Telegrams.back();
+		T.Bursts.assign(Bursts, Bursts + numBursts);
+		T.burstStart.resize(numBursts);
+		T.freqOffset = freqOffset;
+		T.gain = gain;
+
+		uint64_t start = startSample;
+		for (uint16_t i = 0; i < numBursts; ++i) {
+			T.burstStart[i] = start;
+			start += (uint64_t)Bursts[i].get_T_RB() * samplesPerSymbol;
+		}
+		T.endSample = T.burstStart[numBursts - 1] + Modulators[0].getBurstSamples();
+	}
+
+	/**
+	 * @brief	Encode and add several telegrams with identical MPDU length
+	 *
+	 * The telegrams are encoded at once using the bit-sliced encoder of the PHY, see
+	 * Phy::encodeBitSliced(), and then added like with addTelegram().
+	 *
+	 * @param	Phy				PHY for the encoding
+	 * @param	RadioBursts		Array of pointers to the already allocated radio bursts of each telegram for the output of the encoder
+	 * @param	MPDUs			Array of pointers to the MPDU of each telegram
+	 * @param	numTelegrams	Number of telegrams, at most TSUNBPHY_NUM_LANES
+	 * @param	MPDU_Length		MPDU length in bytes, identical for all telegrams
+	 * @param	TSMAPatterns	TSMA pattern of each telegram
+	 * @param	MMODE			Used MacMode
+	 * @param	startSamples	Index of the first sample of the first radio burst of each telegram
+	 * @param	freqOffsets		Frequency offset of each telegram in Hz, which is added to its frequency f_0
+	 * @param	gains			Amplitude of each telegram
+	 * @param	centerFreqReg	Center frequency of the capture as transmitter register setting
+	 * @param	freqRegs		Output array for the frequency f_0 of each telegram in register setting
+	 *
+	 * @return	Number of added telegrams, 0 in case of an error
+	 */
+	template <class Phy_T>
+	uint8_t addTelegrams(Phy_T& Phy, RadioBurst_T* const RadioBursts[], const uint8_t* const MPDUs[], const uint8_t numTelegrams, const uint16_t MPDU_Length,
+			const uint8_t* const TSMAPatterns, const uint8_t MMODE, const uint64_t* const startSamples,
+			const double* const freqOffsets, const float* const gains, const uint32_t centerFreqReg, uint32_t* const freqRegs) {
+		const uint16_t numBursts = Phy.numRadioBursts(MPDU_Length);
+		const uint8_t numEncoded = Phy.encodeBitSliced(RadioBursts, freqRegs, MPDUs, numTelegrams, MPDU_Length, TSMAPatterns, MMODE);
+		for (uint8_t i = 0; i < numEncoded; ++i) {
+			const double freqOffset = ((double)freqRegs[i] - centerFreqReg) * TSUNB_HOST_FREQ_STEP + freqOffsets[i];
+			addTelegram(RadioBursts[i], numBursts, startSamples[i], freqOffset, gains[i]);
+		}
+		return numEncoded;
+	}
+
+	/**
+	 * @brief	Mix the next block and write it to the sink
+	 *
+	 * @param	Sink	Sink for the samples
+	 */
+	template <class Sink_T>
+	void mixBlock(Sink_T& Sink) {
+		const uint16_t numThreads = (uint16_t)Modulators.size();
+		const uint32_t sliceSamples = (blockSamples + numThreads - 1) / numThreads;
+
+		std::vector<std::thread> Threads;
+		for (uint16_t i = 1; i < numThreads; ++i) {
+			Threads.push_back(std::thread(&ChannelMixer::mixSlice, this, i, i * sliceSamples, sliceSamples));
+		}
+		mixSlice(0, 0, sliceSamples);
+		for (size_t i = 0; i < Threads.size(); ++i) {
+			Threads[i].join();
+		}
+
+		Sink.writeSamples(&block[0], blockSamples);
+		position += blockSamples;
+
+		// Remove the telegrams that have been mixed completely
+		typename std::list<Telegram>::iterator it = Telegrams.begin();
+		while (it != Telegrams.end()) {
+			if (it->endSample <= position)
+				it = Telegrams.erase(it);
+			else
+				++it;
+		}
+	}
+
+private:
+	/**
+	 * @brief Telegram with its radio bursts and parameters
+	 */
+	struct Telegram {
+		//! Radio bursts of the telegram
+		std::vector<RadioBurst_T> Bursts;
+
+		//! Index of the first sample of each radio burst
+		std::vector<uint64_t> burstStart;
+
+		//! Index of the sample after the last radio burst
+		uint64_t endSample;
+
+		//! Frequency offset of f_0 in Hz
+		double freqOffset;
+
+		//! Amplitude
+		float gain;
+	};
+
+	/**
+	 * @brief	Mix a slice of the current block
+	 *
+	 * @param	threadIdx		Index of the thread, selects the modulator
+	 * @param	offset			Offset of the slice within the block
+	 * @param	num				Number of samples of the slice
+	 */
+	void mixSlice(const uint16_t threadIdx, const uint32_t offset, uint32_t num) {
+		if (offset >= blockSamples)
+			return;
+		if (num > blockSamples - offset)
+			num = blockSamples - offset;
+
+		MskModulator<RadioBurst_T>& Modulator = Modulators[threadIdx];
+		const uint32_t burstSamples = Modulator.getBurstSamples();
+		const uint64_t sliceStart = position + offset;
+		const uint64_t sliceEnd = sliceStart + num;
+		float* const out = &block[2 * (size_t)offset];
+
+		for (uint32_t n = 0; n < 2 * num; ++n) {
+			out[n] = 0.0f;
+		}
+
+		for (typename std::list<Telegram>::const_iterator it = Telegrams.begin(); it != Telegrams.end(); ++it) {
+			const Telegram& T = *it;
+			if (T.burstStart[0] >= sliceEnd || T.endSample <= sliceStart)
+				continue;
+
+			for (size_t i = 0; i < T.Bursts.size(); ++i) {
+				const uint64_t burstStart = T.burstStart[i];
+				if (burstStart >= sliceEnd)
+					break;
+				if (burstStart + burstSamples <= sliceStart || T.Bursts[i].getBurstLength() == 0)
+					continue;
+
+				const float* const iq = Modulator.modulateBurst(T.Bursts[i], T.freqOffset, T.gain);
+
+				// Add the part of the radio burst within the slice
+				const uint64_t first = burstStart > sliceStart ? burstStart : sliceStart;
+				const uint64_t last = burstStart + burstSamples < sliceEnd ? burstStart + burstSamples : sliceEnd;
+				const float* const in = &iq[2 * (first - burstStart)];
+				float* const dst = &out[2 * (first - sliceStart)];
+				const uint32_t numValues = 2 * (uint32_t)(last - first);
+				for (uint32_t n = 0; n < numValues; ++n) {
+					dst[n] += in[n];
+				}
+			}
+		}
+	}
+
+	//! Oversampling factor
+	const uint16_t samplesPerSymbol;
+
+	//! Number of complex samples per block
+	const uint32_t blockSamples;
+
+	//! Index of the first sample of the next block
+	uint64_t position;
+
+	//! Interleaved I/Q samples of the current block
+	std::vector<float> block;
+
+	//! One modulator per thread, as the modulators contain the temporary buffers
+	std::vector<MskModulator<RadioBurst_T> > Modulators;
+
+	//! Telegrams that have not been mixed completely
+	std::list<Telegram> Telegrams;
+};
+
+};	// namespace Host
+};	// namespace TsUnbLib
+
+#endif	// TSUNB_HOST_CHANNEL_MIXER_H_
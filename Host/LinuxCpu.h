@@ -0,0 +1,546 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+
+/**
+ * @brief	Linux platform implementation for TS-UNB (host only)
+ *
+ * @file	LinuxCpu.h
+ *
+ */
+
+
+#ifndef TSUNB_HOST_LINUX_CPU_H_
+#define TSUNB_HOST_LINUX_CPU_H_
+
+#ifndef __linux__
+#error "The Linux platform implementation requires a Linux system"
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+#include "Rfm69Emulator.h"
+
+namespace TsUnbLib {
+namespace Host {
+
+
+//! SPI clock used for spidev devices in Hz
+#define TSUNB_HOST_SPI_SPEED			4000000
+
+
+/**
+ * @brief SPI sink passing the transactions to an Rfm69Emulator
+ *
+ * The reconstructed bursts are timestamped in nanoseconds of CLOCK_MONOTONIC.
+ */
+class EmulatorSpi {
+public:
+	EmulatorSpi() : Emulator(1.0e9) {
+	}
+
+	/**
+	 * @brief Performs an SPI transaction
+	 *
+	 * @param	data	Bytes to be transmitted, replaced by the received bytes
+	 * @param	num		Number of bytes
+	 * @param	timeNs	Time of the transaction in nanoseconds
+	 */
+	void spiTransfer(uint8_t* const data, const uint8_t num, const uint64_t timeNs) {
+		Emulator.setTime(timeNs);
+		Emulator.spiTransfer(data, num);
+	}
+
+	//! Emulated transceiver
+	Rfm69Emulator Emulator;
+};
+
+
+/**
+ * @brief SPI sink writing all transactions as text lines into a file
+ *
+ * Each line contains the time in nanoseconds followed by the transmitted bytes in hex.
+ * Read accesses return the value 0x02 for all registers, which satisfies the chip
+ * detection of Rfm69hw::init().
+ */
+class FileSpi {
+public:
+	FileSpi() : File(stdout) {
+	}
+
+	/**
+	 * @brief Sets the output file, the default is stdout
+	 *
+	 * @param	File_	Opened output file
+	 */
+	void setFile(FILE* const File_) {
+		File = File_;
+	}
+
+	/**
+	 * @brief Performs an SPI transaction
+	 *
+	 * @param	data	Bytes to be transmitted, replaced by the received bytes
+	 * @param	num		Number of bytes
+	 * @param	timeNs	Time of the transaction in nanoseconds
+	 */
+	void spiTransfer(uint8_t* const data, const uint8_t num, const uint64_t timeNs) {
+		fprintf(File, "%llu", (unsigned long long)timeNs);
+		for (uint8_t i = 0; i < num; ++i) {
+			fprintf(File, " %02x", data[i]);
+		}
+		fprintf(File, "\n");
+
+		if (num > 0 && (data[0] & 0x80) == 0) {
+			for (uint8_t i = 1; i < num; ++i) {
+				data[i] = 0x02;
+			}
+		}
+	}
+
+private:
+	//! Output file
+	FILE* File;
+};
+
+
+/**
+ * @brief SPI sink using a Linux spidev device, e.g. an RFM69HW connected to a Raspberry Pi
+ *
+ * Each transaction is transferred with a single SPI_IOC_MESSAGE, i.e. the chip select
+ * is kept active for the complete transaction.
+ */
+class SpidevSpi {
+public:
+	SpidevSpi() : numErrors(0), fd(-1) {
+	}
+
+	~SpidevSpi() {
+		if (fd >= 0)
+			close(fd);
+	}
+
+	/**
+	 * @brief Opens the device, must be called before Rfm69hw::init()
+	 *
+	 * @param	device	Path of the device, e.g. "/dev/spidev0.0"
+	 *
+	 * @return	0 if OK, negative value in case of errors
+	 */
+	int16_t openDevice(const char* const device) {
+		if (fd >= 0)
+			close(fd);
+
+		fd = open(device, O_RDWR);
+		if (fd < 0)
+			return -1;
+
+		uint8_t mode = SPI_MODE_0;
+		uint32_t speed = TSUNB_HOST_SPI_SPEED;
+		if (ioctl(fd, SPI_IOC_WR_MODE, &mode) < 0 || ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed) < 0) {
+			close(fd);
+			fd = -1;
+			return -1;
+		}
+		return 0;
+	}
+
+	/**
+	 * @brief Performs an SPI transaction
+	 *
+	 * @param	data	Bytes to be transmitted, replaced by the received bytes
+	 * @param	num		Number of bytes
+	 */
+	void spiTransfer(uint8_t* const data, const uint8_t num, const uint64_t) {
+		struct spi_ioc_transfer transfer = {};
+		transfer.tx_buf = (unsigned long)data;
+		transfer.rx_buf = (unsigned long)data;
+		transfer.len = num;
+		transfer.speed_hz = TSUNB_HOST_SPI_SPEED;
+		transfer.bits_per_word = 8;
+		if (fd < 0 || ioctl(fd, SPI_IOC_MESSAGE(1), &transfer) < 0)
+			++numErrors;
+	}
+
+	//! Number of failed transactions
+	uint32_t numErrors;
+
+private:
+	//! File descriptor of the device
+	int fd;
+
+	// The file descriptor must not be copied
+	SpidevSpi(const SpidevSpi&);
+	SpidevSpi& operator=(const SpidevSpi&);
+};
+
+
+/**
+ * @brief Timing statistics of the timer events
+ *
+ * The latency is the difference between the actual wake up time and the deadline.
+ */
+struct TimingStatistics {
+	//! Number of timer events
+	uint32_t numEvents;
+
+	//! Number of deadlines, which had already passed when waitTimer() was called
+	uint32_t numMissed;
+
+	//! Maximum latency in nanoseconds
+	int64_t maxLatencyNs;
+
+	//! Sum of the latencies in nanoseconds
+	int64_t sumLatencyNs;
+
+	/**
+	 * @brief Returns the mean latency in nanoseconds
+	 */
+	double getMeanLatencyNs() const {
+		return numEvents ? (double)sumLatencyNs / numEvents : 0.0;
+	}
+};
+
+
+/**
+ * @brief Platform dependent TS-UNB implementation for Linux systems
+ *
+ * This class implements the Cpu_T interface of Trx::Rfm69hw on Linux. The symbol clock is
+ * generated with clock_nanosleep() and absolute deadlines on CLOCK_MONOTONIC. The deadlines of
+ * addTimerDelay() are calculated from the total number of symbols since initTimer() using
+ * integer arithmetic, i.e. there is no accumulated drift. The deviation of each wake up from its
+ * deadline is collected in TimingStatistics.
+ *
+ * The SPI transactions are passed to the SpiSink_T, which has to offer the method
+ * void spiTransfer(uint8_t* data, uint8_t num, uint64_t timeNs), see EmulatorSpi, FileSpi and
+ * SpidevSpi. The transfers are performed in place, i.e. the received bytes replace the
+ * transmitted ones. The sink is accessible as member Spi, e.g. to open a spidev device before
+ * Rfm69hw::init() is called.
+ *
+ * The timer ticks used by setTimerCompare() and TS_UNB_BIT_DURATION_Q16 correspond to the
+ * ATmega328p implementation, i.e. a 16 bit counter with the clock TIMER_CLOCK. A timer callback
+ * is called after each timer event, interrupt driven transmissions are performed by calling
+ * runTimerEvent() until the transmission has finished, e.g. in a separate thread.
+ *
+ * @tparam	SpiSink_T			SPI sink
+ * @tparam	SYMBOL_RATE_MULT	TS-UNB symbol rate in multiples of 49.591064453125, see ArduinoTsUnb
+ * @tparam	TIMER_CLOCK			Clock of the timer ticks in Hz (default is 16MHz / 256)
+ */
+template <class SpiSink_T, uint16_t SYMBOL_RATE_MULT = 48, uint32_t TIMER_CLOCK = 62500>
+class LinuxCpu {
+public:
+	LinuxCpu() : numWatchdogResets(0), numTimerErrors(0),
+			startNs(0), deadlineNs(0), symbols(0), compareTicks(0), running(false), callback(0), context(0) {
+		resetStatistics();
+	}
+
+	//! TS-UNB symbol rate in multiples of 49.591064453125, see ArduinoTsUnb
+	static constexpr uint16_t TS_UNB_SYMBOL_RATE_MULT = SYMBOL_RATE_MULT;
+
+	//! Bit duration in timer ticks, see ArduinoTsUnb
+	static constexpr float TS_UNB_BIT_DURATION = (double)TIMER_CLOCK / (49.591064453125 * (double)SYMBOL_RATE_MULT);
+
+	//! Bit duration in timer ticks as Q16.16 fixed point value, see ArduinoTsUnb
+	static constexpr uint32_t TS_UNB_BIT_DURATION_Q16 = (uint32_t)((double)TIMER_CLOCK / (49.591064453125 * (double)SYMBOL_RATE_MULT) * 65536.0 + 0.5);
+
+	/**
+	 * @brief Init the timer, the time reference is the current time
+	 */
+	void initTimer() {
+		startNs = getTimeNs();
+		deadlineNs = startNs;
+		symbols = 0;
+		compareTicks = 0;
+		running = false;
+	}
+
+	/**
+	 * @brief Start the timer
+	 */
+	void startTimer() {
+		running = true;
+	}
+
+	/**
+	 * @brief Stop the timer
+	 */
+	void stopTimer() {
+		running = false;
+	}
+
+	/**
+	 * @brief Add a delay to the deadline of the next timer event
+	 *
+	 * The symbol duration is 4096 / (203125 * SYMBOL_RATE_MULT) seconds, i.e. the deadline is
+	 * calculated exactly from the total number of symbols and rounded to nanoseconds.
+	 *
+	 * @param count Delay in TX symbols
+	 */
+	void addTimerDelay(const int32_t count) {
+		const int64_t divisor = 203125LL * SYMBOL_RATE_MULT;
+		symbols += count;
+		deadlineNs = startNs + (symbols * 4096000000000LL + divisor / 2) / divisor;
+	}
+
+	/**
+	 * @brief Set the absolute deadline of the next timer event in timer ticks
+	 *
+	 * The 16 bit value is extended to the first tick value after the previous compare value,
+	 * which matches the behavior of a 16 bit hardware counter.
+	 *
+	 * @param timerCompareMatch Timer value of the next event in timer ticks
+	 */
+	void setTimerCompare(const uint16_t timerCompareMatch) {
+		compareTicks += (uint16_t)(timerCompareMatch - (uint16_t)compareTicks);
+		deadlineNs = startNs + (compareTicks * 1000000000LL + TIMER_CLOCK / 2) / TIMER_CLOCK;
+	}
+
+	/**
+	 * @brief Wait until the deadline of the timer event
+	 *
+	 * @param	lowPower	Low power wait, without effect on Linux
+	 */
+	void waitTimer(const bool lowPower = false) {
+		(void)lowPower;
+		runTimerEvent();
+	}
+
+	/**
+	 * @brief Wait until the deadline of the timer event and call the timer callback
+	 *
+	 * @return	false if the timer is not running
+	 */
+	bool runTimerEvent() {
+		if (!running) {
+			++numTimerErrors;
+			return false;
+		}
+
+		if (getTimeNs() > deadlineNs)
+			++Statistics.numMissed;
+
+		struct timespec deadline;
+		deadline.tv_sec = (time_t)(deadlineNs / 1000000000LL);
+		deadline.tv_nsec = (long)(deadlineNs % 1000000000LL);
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, 0) == EINTR) {
+		}
+
+		const int64_t latencyNs = getTimeNs() - deadlineNs;
+		++Statistics.numEvents;
+		Statistics.sumLatencyNs += latencyNs;
+		if (latencyNs > Statistics.maxLatencyNs)
+			Statistics.maxLatencyNs = latencyNs;
+
+		if (callback)
+			callback(context);
+		return true;
+	}
+
+	/**
+	 * @brief Returns the time since initTimer() in timer ticks, modulo 2^16
+	 */
+	uint16_t getTimerCount() const {
+		return (uint16_t)((getTimeNs() - startNs) * TIMER_CLOCK / 1000000000LL);
+	}
+
+	/**
+	 * @brief Returns the deadline of the next timer event in timer ticks, modulo 2^16
+	 */
+	uint16_t getTimerCompare() const {
+		return (uint16_t)(((deadlineNs - startNs) * TIMER_CLOCK + 500000000LL) / 1000000000LL);
+	}
+
+	/**
+	 * @brief Set the function called after every timer event
+	 *
+	 * @param callback_ Function called after every timer event, null pointer to disable
+	 * @param context_  Context passed to the \p callback_
+	 */
+	void setTimerCallback(void (* const callback_)(void*), void* const context_) {
+		callback = callback_;
+		context = context_;
+	}
+
+	void spiInit(void) {
+	}
+
+	void spiDeinit(void) {
+	}
+
+	/**
+	 * @brief Sends multiple bytes within one SPI transaction
+	 */
+	void spiSend(const uint8_t* const dataOut, const uint8_t numBytes) {
+		uint8_t data[256];
+		for (uint8_t i = 0; i < numBytes; ++i) {
+			data[i] = dataOut[i];
+		}
+		Spi.spiTransfer(data, numBytes, getTimeNs());
+	}
+
+	/**
+	 * @brief Writes multiple bytes to a single register address within one SPI transaction
+	 */
+	void spiSendBurst(const uint8_t address, const uint8_t* const dataOut, const uint8_t numBytes) {
+		uint8_t data[256];
+		data[0] = address;
+		for (uint8_t i = 0; i < numBytes && i < 255; ++i) {
+			data[i + 1] = dataOut[i];
+		}
+		Spi.spiTransfer(data, numBytes < 255 ? numBytes + 1 : 255, getTimeNs());
+	}
+
+	/**
+	 * @brief Sends and receives multiple bytes within one SPI transaction
+	 */
+	void spiSendReceive(uint8_t* const dataInOut, const uint8_t numBytes) {
+		Spi.spiTransfer(dataInOut, numBytes, getTimeNs());
+	}
+
+	void resetWatchdog() {
+		++numWatchdogResets;
+	}
+
+	/**
+	 * @brief Returns the timing statistics since the last reset
+	 */
+	const TimingStatistics& getStatistics() const {
+		return Statistics;
+	}
+
+	/**
+	 * @brief Resets the timing statistics
+	 */
+	void resetStatistics() {
+		Statistics.numEvents = 0;
+		Statistics.numMissed = 0;
+		Statistics.maxLatencyNs = 0;
+		Statistics.sumLatencyNs = 0;
+	}
+
+	/**
+	 * @brief Returns the current time of CLOCK_MONOTONIC in nanoseconds
+	 */
+	static int64_t getTimeNs() {
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (int64_t)now.tv_sec * 1000000000LL + now.tv_nsec;
+	}
+
+	//! SPI sink
+	SpiSink_T Spi;
+
+	//! Number of watchdog resets
+	uint32_t numWatchdogResets;
+
+	//! Number of waits for a stopped timer
+	uint32_t numTimerErrors;
+
+private:
+	//! Time of initTimer() in nanoseconds
+	int64_t startNs;
+
+	//! Deadline of the next timer event in nanoseconds
+	int64_t deadlineNs;
+
+	//! Number of symbols since initTimer()
+	int64_t symbols;
+
+	//! Extended compare value in timer ticks since initTimer()
+	int64_t compareTicks;
+
+	//! True if the timer is running
+	bool running;
+
+	//! Timing statistics
+	TimingStatistics Statistics;
+
+	//! Function called after every timer event
+	void (*callback)(void*);
+
+	//! Context passed to callback
+	void* context;
+};
+
+
+};	// namespace Host
+};	// namespace TsUnbLib
+
+#endif	// TSUNB_HOST_LINUX_CPU_H_
@@ -0,0 +1,455 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+/**
+ * @brief	MSK baseband modulator for TS-UNB radio bursts (host only)
+ *
+ * @file	MskModulator.h
+ *
+ */
+
+
+#ifndef TSUNB_HOST_MSK_MODULATOR_H_
+#define TSUNB_HOST_MSK_MODULATOR_H_
+
+#ifdef __AVR_ARCH__
+#error "The MSK modulator is intended for host systems only"
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+namespace TsUnbLib {
+namespace Host {
+
+
+//! TS-UNB symbol rate of the standard mode in symbols/s
+#define TSUNB_HOST_SYMBOL_RATE			2380.37109375
+
+//! Frequency step of one transmitter register value in Hz (RFM69: 32MHz / 2^19)
+#define TSUNB_HOST_FREQ_STEP			61.03515625
+
+//! Length of the Gaussian frequency pulse in symbols
+#define TSUNB_HOST_GAUSS_SPAN			4
+
+//! Number of samples that are written to a sink at once
+#define TSUNB_HOST_BLOCK_SAMPLES		4096
+
+
+/**
+ * @brief Sink writing the samples to a file
+ *
+ * The samples are written as interleaved 32 bit float I/Q values in host byte order
+ * (e.g. the "cf32" format of many SDR tools).
+ */
+class FileSink {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param	File_	Opened output file
+	 */
+	FileSink(FILE* const File_) : numSamples(0), File(File_) {
+	}
+
+	/**
+	 * @brief Write samples
+	 *
+	 * @param	iq			Interleaved I/Q samples
+	 * @param	num			Number of complex samples
+	 */
+	void writeSamples(const float* const iq, const uint32_t num) {
+		numSamples += fwrite(iq, 2 * sizeof(float), num, File);
+	}
+
+	//! Number of samples written so far
+	uint64_t numSamples;
+
+private:
+	//! Output file
+	FILE* const File;
+};
+
+
+/**
+ * @brief Sink writing the samples to a memory buffer
+ *
+ * Samples that do not fit into the buffer are dropped and only counted.
+ */
+class BufferSink {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param	Buffer_		Buffer for interleaved I/Q samples, 2 * capacity_ floats
+	 * @param	capacity_	Capacity of the buffer in complex samples
+	 */
+	BufferSink(float* const Buffer_, const uint64_t capacity_) : numSamples(0), Buffer(Buffer_), capacity(capacity_) {
+	}
+
+	/**
+	 * @brief Write samples
+	 *
+	 * @param	iq			Interleaved I/Q samples
+	 * @param	num			Number of complex samples
+	 */
+	void writeSamples(const float* const iq, const uint32_t num) {
+		for (uint32_t n = 0; n < num && numSamples + n < capacity; ++n) {
+			Buffer[2 * (numSamples + n)] = iq[2 * n];
+			Buffer[2 * (numSamples + n) + 1] = iq[2 * n + 1];
+		}
+		numSamples += num;
+	}
+
+	//! Number of samples written so far, including the dropped ones
+	uint64_t numSamples;
+
+private:
+	//! Output buffer
+	float* const Buffer;
+
+	//! Capacity of the buffer in complex samples
+	const uint64_t capacity;
+};
+
+
+/**
+ * @brief Sink that only counts the samples, e.g. for benchmarks
+ */
+class NullSink {
+public:
+	NullSink() : numSamples(0) {
+	}
+
+	/**
+	 * @brief Write samples
+	 *
+	 * @param	iq			Interleaved I/Q samples
+	 * @param	num			Number of complex samples
+	 */
+	void writeSamples(const float* const, const uint32_t num) {
+		numSamples += num;
+	}
+
+	//! Number of samples written so far
+	uint64_t numSamples;
+};
+
+
+/**
+ * @brief MSK baseband modulator for TS-UNB radio bursts
+ *
+ * This template class converts the radio bursts of a TS-UNB telegram into complex baseband
+ * samples, e.g. to test receivers without transmitter hardware or to drive SDR transmitters.
+ * The radio bursts generated by the PHY are already MSK precoded. Therefore, each bit is
+ * transmitted as 2-FSK with the frequency deviation symbolRate / 4 (bit 1 at the higher
+ * frequency), as done by the RFM69. Optionally the frequency pulses are Gaussian shaped (GMSK).
+ *
+ * The frequency of each radio burst is its carrier offset times the frequency step of the
+ * transmitter register, plus an optional offset for the complete telegram. Consequently, f_0 of
+ * the telegram is at 0Hz, unless an offset is given. The times T_RB between the radio bursts are
+ * filled with zeros, and the phase of each radio burst starts at 0.
+ *
+ * The samples are written as interleaved I/Q floats to a sink, which has to offer the method
+ * void writeSamples(const float* iq, uint32_t numSamples), see FileSink, BufferSink and NullSink.
+ * The loops over the samples have no dependencies between the iterations except the phase
+ * accumulation, so that they can be vectorized by the compiler (e.g. -O3 -ffast-math).
+ *
+ * The template parameter RadioBurst_T is the radio burst class used by the PHY.
+ *
+ */
+template <class RadioBurst_T>
+class MskModulator {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param	samplesPerSymbol_	Oversampling factor, i.e. the sample rate is samplesPerSymbol_ * symbolRate_
+	 * @param	gaussianBT			Bandwidth-time product of the Gaussian filter, 0 for plain MSK
+	 * @param	freqStep_			Frequency step of one transmitter register value in Hz
+	 * @param	symbolRate_			Symbol rate in symbols/s
+	 */
+	MskModulator(const uint16_t samplesPerSymbol_ = 8, const double gaussianBT = 0.0,
+			const double freqStep_ = TSUNB_HOST_FREQ_STEP, const double symbolRate_ = TSUNB_HOST_SYMBOL_RATE) :
+			samplesPerSymbol(samplesPerSymbol_ > 0 ? samplesPerSymbol_ : 1), freqStep(freqStep_), symbolRate(symbolRate_),
+			nrz((RadioBurst_T::BURST_LENGTH + TSUNB_HOST_GAUSS_SPAN) * samplesPerSymbol + 1),
+			freq(RadioBurst_T::BURST_LENGTH * samplesPerSymbol),
+			phase(RadioBurst_T::BURST_LENGTH * samplesPerSymbol),
+			iq(2 * RadioBurst_T::BURST_LENGTH * samplesPerSymbol),
+			zeros(2 * TSUNB_HOST_BLOCK_SAMPLES, 0.0f) {
+
+		if (gaussianBT > 0.0) {
+			// Gaussian pulse with sigma = sqrt(ln 2) / (2 pi BT) symbols, normalized to unit area
+			const double sigma = sqrt(log(2.0)) / (2.0 * M_PI * gaussianBT) * samplesPerSymbol;
+			const int32_t numTaps = TSUNB_HOST_GAUSS_SPAN * samplesPerSymbol + 1;
+			double sum = 0.0;
+
+			taps.resize(numTaps);
+			for (int32_t k = 0; k < numTaps; ++k) {
+				const double t = k - (numTaps - 1) / 2.0;
+				taps[k] = (float)exp(-t * t / (2.0 * sigma * sigma));
+				sum += taps[k];
+			}
+			for (int32_t k = 0; k < numTaps; ++k) {
+				taps[k] = (float)(taps[k] / sum);
+			}
+		}
+	}
+
+	/**
+	 * @brief	Get the sample rate
+	 *
+	 * @return	Sample rate in samples/s
+	 */
+	double getSampleRate() const {
+		return samplesPerSymbol * symbolRate;
+	}
+
+	/**
+	 * @brief	Get the number of samples of a single radio burst
+	 *
+	 * @return	Number of complex samples
+	 */
+	uint32_t getBurstSamples() const {
+		return RadioBurst_T::BURST_LENGTH * samplesPerSymbol;
+	}
+
+	/**
+	 * @brief	Get the number of samples of a telegram
+	 *
+	 * @param	Bursts			Radio bursts of the telegram
+	 * @param	numBursts		Number of radio bursts
+	 *
+	 * @return	Number of complex samples from the start of the first to the end of the last radio burst
+	 */
+	uint64_t getTelegramSamples(const RadioBurst_T* const Bursts, const uint16_t numBursts) const {
+		if (numBursts == 0)
+			return 0;
+
+		uint64_t symbols = RadioBurst_T::BURST_LENGTH;
+		for (uint16_t i = 0; i + 1 < numBursts; ++i) {
+			symbols += Bursts[i].get_T_RB();
+		}
+		return symbols * samplesPerSymbol;
+	}
+
+	/**
+	 * @brief	Modulate a single radio burst
+	 *
+	 * The output remains valid until the next call of a modulation method.
+	 *
+	 * @param	Burst			Radio burst, must not be punctured
+	 * @param	freqOffset		Additional frequency offset in Hz
+	 * @param	gain			Amplitude of the samples
+	 *
+	 * @return	Interleaved I/Q samples, getBurstSamples() complex samples
+	 */
+	const float* modulateBurst(const RadioBurst_T& Burst, const double freqOffset = 0.0, const float gain = 1.0f) {
+		const uint32_t numSamples = getBurstSamples();
+		const uint8_t* const data = Burst.getBurst();
+
+		// Rectangular frequency pulses with zeros before and after the burst for the Gaussian filter
+		const uint32_t pad = TSUNB_HOST_GAUSS_SPAN * samplesPerSymbol / 2;
+		for (uint32_t n = 0; n < pad; ++n) {
+			nrz[n] = 0.0f;
+		}
+		for (uint32_t n = pad + numSamples; n < nrz.size(); ++n) {
+			nrz[n] = 0.0f;
+		}
+		for (uint16_t s = 0; s < RadioBurst_T::BURST_LENGTH; ++s) {
+			const float value = (data[s >> 3] & (0x80 >> (s & 0x07))) ? 1.0f : -1.0f;
+			float* const out = &nrz[pad + s * samplesPerSymbol];
+			for (uint16_t k = 0; k < samplesPerSymbol; ++k) {
+				out[k] = value;
+			}
+		}
+
+		if (taps.empty()) {
+			for (uint32_t n = 0; n < numSamples; ++n) {
+				freq[n] = nrz[pad + n];
+			}
+		}
+		else {
+			const uint32_t numTaps = taps.size();
+			const uint32_t offset = pad - (numTaps - 1) / 2;
+			for (uint32_t n = 0; n < numSamples; ++n) {
+				const float* const in = &nrz[offset + n];
+				float sum = 0.0f;
+				for (uint32_t k = 0; k < numTaps; ++k) {
+					sum += taps[k] * in[k];
+				}
+				freq[n] = sum;
+			}
+		}
+
+		// Phase accumulation, done in double precision to avoid phase drift within the burst
+		const double deviation = M_PI / (2.0 * samplesPerSymbol);
+		const double carrier = 2.0 * M_PI * (Burst.getCarrierOffset() * freqStep + freqOffset) / getSampleRate();
+		double phi = 0.0;
+		for (uint32_t n = 0; n < numSamples; ++n) {
+			phase[n] = (float)phi;
+			phi += carrier + deviation * freq[n];
+			phi -= 2.0 * M_PI * floor(phi / (2.0 * M_PI) + 0.5);
+		}
+
+		for (uint32_t n = 0; n < numSamples; ++n) {
+			iq[2 * n] = gain * cosf(phase[n]);
+			iq[2 * n + 1] = gain * sinf(phase[n]);
+		}
+
+		return &iq[0];
+	}
+
+	/**
+	 * @brief	Modulate a complete telegram
+	 *
+	 * @param	Bursts			Radio bursts of the telegram
+	 * @param	numBursts		Number of radio bursts
+	 * @param	Sink			Sink for the samples
+	 * @param	freqOffset		Additional frequency offset in Hz
+	 *
+	 * @return	Number of complex samples written to the sink
+	 */
+	template <class Sink_T>
+	uint64_t modulate(const RadioBurst_T* const Bursts, const uint16_t numBursts, Sink_T& Sink,
+			const double freqOffset = 0.0) {
+		const uint32_t burstSamples = getBurstSamples();
+		uint64_t numSamples = 0;
+
+		for (uint16_t i = 0; i < numBursts; ++i) {
+			if (Bursts[i].getBurstLength() != 0)
+				Sink.writeSamples(modulateBurst(Bursts[i], freqOffset), burstSamples);
+			else
+				writeSilence(Sink, burstSamples);
+			numSamples += burstSamples;
+
+			if (i + 1 < numBursts && Bursts[i].get_T_RB() > RadioBurst_T::BURST_LENGTH) {
+				const uint64_t gap = (uint64_t)(Bursts[i].get_T_RB() - RadioBurst_T::BURST_LENGTH) * samplesPerSymbol;
+				writeSilence(Sink, gap);
+				numSamples += gap;
+			}
+		}
+
+		return numSamples;
+	}
+
+private:
+	/**
+	 * @brief	Write zeros to the sink
+	 *
+	 * @param	Sink			Sink for the samples
+	 * @param	numSamples		Number of complex samples
+	 */
+	template <class Sink_T>
+	void writeSilence(Sink_T& Sink, uint64_t numSamples) const {
+		while (numSamples > 0) {
+			const uint32_t num = numSamples > TSUNB_HOST_BLOCK_SAMPLES ? TSUNB_HOST_BLOCK_SAMPLES : (uint32_t)numSamples;
+			Sink.writeSamples(&zeros[0], num);
+			numSamples -= num;
+		}
+	}
+
+	//! Oversampling factor
+	const uint16_t samplesPerSymbol;
+
+	//! Frequency step of one transmitter register value in Hz
+	const double freqStep;
+
+	//! Symbol rate in symbols/s
+	const double symbolRate;
+
+	//! Taps of the Gaussian filter, empty for plain MSK
+	std::vector<float> taps;
+
+	//! Rectangular frequency pulses of the current burst including padding
+	std::vector<float> nrz;
+
+	//! Normalized frequency of each sample of the current burst
+	std::vector<float> freq;
+
+	//! Phase of each sample of the current burst
+	std::vector<float> phase;
+
+	//! Interleaved I/Q samples of the current burst
+	std::vector<float> iq;
+
+	//! Zeros for the gaps between the radio bursts
+	const std::vector<float> zeros;
+};
+
+};	// namespace Host
+};	// namespace TsUnbLib
+
+#endif	// TSUNB_HOST_MSK_MODULATOR_H_
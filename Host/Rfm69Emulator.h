@@ -0,0 +1,674 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+
+/**
+ * @brief	Register level emulator of the HopeRF RFM69HW (host only)
+ *
+ * @file	Rfm69Emulator.h
+ *
+ */
+
+
+#ifndef TSUNB_HOST_RFM69_EMULATOR_H_
+#define TSUNB_HOST_RFM69_EMULATOR_H_
+
+#ifdef __AVR_ARCH__
+#error "The RFM69 emulator is intended for host systems only"
+#endif
+
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+
+namespace TsUnbLib {
+namespace Host {
+
+
+//! Crystal oscillator frequency of the RFM69 in Hz
+#define TSUNB_HOST_RFM69_FXOSC			32000000.0
+
+//! Size of the RFM69 FIFO in bytes
+#define TSUNB_HOST_RFM69_FIFO_SIZE		66
+
+//! Value of the mode bits in 'RegOpMode' for sleep mode
+#define TSUNB_HOST_RFM69_MODE_SLEEP		0
+
+//! Value of the mode bits in 'RegOpMode' for standby mode
+#define TSUNB_HOST_RFM69_MODE_STDBY		1
+
+//! Value of the mode bits in 'RegOpMode' for frequency synthesizer mode
+#define TSUNB_HOST_RFM69_MODE_FS		2
+
+//! Value of the mode bits in 'RegOpMode' for TX mode
+#define TSUNB_HOST_RFM69_MODE_TX		3
+
+
+/**
+ * @brief Radio burst reconstructed by the RFM69 emulator
+ *
+ * All times are given in the time unit of the emulator, see Rfm69Emulator::Rfm69Emulator().
+ */
+struct EmulatedBurst {
+	//! Time of the switch into TX mode
+	uint64_t startTime;
+
+	//! Time of the switch out of TX mode
+	uint64_t endTime;
+
+	//! Active 'RegFrf' value during the burst
+	uint32_t frf;
+
+	//! 'RegPaLevel' value during the burst
+	uint8_t paLevel;
+
+	//! Mode bits of 'RegOpMode' before the switch into TX mode
+	uint8_t prevMode;
+
+	//! Mode bits of 'RegOpMode' after the switch out of TX mode
+	uint8_t nextMode;
+
+	//! Number of bits transmitted according to the duration of the burst and the bit rate
+	uint16_t numBits;
+
+	//! FIFO content at the start of the burst, including bytes written during the burst
+	std::vector<uint8_t> data;
+
+	//! Number of SPI transactions since the end of the previous burst
+	uint32_t numTransactions;
+
+	//! Number of SPI bytes since the end of the previous burst, including the address bytes
+	uint32_t numBytes;
+
+	/**
+	 * @brief Returns the frequency of the burst in Hz
+	 */
+	double getFrequency() const {
+		return frf * (TSUNB_HOST_RFM69_FXOSC / 524288.0);
+	}
+
+	/**
+	 * @brief Returns a bit of the FIFO content, MSB first as transmitted by the RFM69
+	 *
+	 * @param	bitIdx	Index of the bit
+	 *
+	 * @return	Bit value, 0 if the bit was not written to the FIFO
+	 */
+	uint8_t getBit(const uint16_t bitIdx) const {
+		if (bitIdx / 8 >= data.size())
+			return 0;
+		return (data[bitIdx / 8] >> (7 - bitIdx % 8)) & 1;
+	}
+};
+
+
+/**
+ * @brief Register level emulator of the HopeRF RFM69HW
+ *
+ * This class emulates the SPI register map of the RFM69HW as far as it is used by the
+ * Trx::Rfm69hw driver, i.e. the configuration presets, 'RegOpMode', 'RegFrf', 'RegPaLevel'
+ * and the FIFO. Register accesses use the SPI protocol of the RFM69: the first byte contains
+ * the address and the write flag (bit 7), the following bytes access consecutive registers,
+ * except for the FIFO at address 0.
+ *
+ * Every period in TX mode is reconstructed as an EmulatedBurst with its start and end time,
+ * the active frequency, the PA level and the FIFO content. As in the RFM69, a new frequency is
+ * only applied after 'RegFrfLsb' has been written. The number of transmitted bits is derived
+ * from the duration in TX mode and the bit rate registers. The remaining FIFO content is
+ * discarded when the TX mode is left, which is the behavior the driver relies on.
+ *
+ * The emulator has no notion of time itself. The user, e.g. EmulatorCpu, sets the current time
+ * with setTime() before each SPI transaction.
+ */
+class Rfm69Emulator {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param	timeBase_	Number of time units per second, e.g. 1e9 for nanoseconds
+	 */
+	Rfm69Emulator(const double timeBase_ = 1.0e9) : timeBase(timeBase_) {
+		reset();
+	}
+
+	/**
+	 * @brief Resets the registers to their power on values and removes all reconstructed bursts
+	 */
+	void reset() {
+		for (uint16_t i = 0; i < 0x80; ++i) {
+			regs[i] = 0;
+		}
+		regs[0x01] = 0x04;	// RegOpMode: standby
+		regs[0x03] = 0x1A;	// RegBitrateMsb
+		regs[0x04] = 0x0B;	// RegBitrateLsb
+		regs[0x06] = 0x52;	// RegFdevLsb
+		regs[0x07] = 0xE4;	// RegFrfMsb
+		regs[0x08] = 0xC0;	// RegFrfMid
+		regs[0x0C] = 0x02;	// Checked by Rfm69hw::init()
+		regs[0x10] = 0x24;	// RegVersion
+		regs[0x11] = 0x9F;	// RegPaLevel
+		regs[0x12] = 0x09;	// RegPaRamp
+		frf = getRegFrf();
+
+		time = 0;
+		Fifo.clear();
+		Bursts.clear();
+		numTransactions = 0;
+		numBytes = 0;
+		numFifoOverflows = 0;
+		numFifoUnderruns = 0;
+		transactionsSinceBurst = 0;
+		bytesSinceBurst = 0;
+	}
+
+	/**
+	 * @brief Sets the current time
+	 *
+	 * @param	time_	Time in the units given to the constructor
+	 */
+	void setTime(const uint64_t time_) {
+		time = time_;
+	}
+
+	/**
+	 * @brief Performs an SPI transaction
+	 *
+	 * @param	data	Address byte followed by the data bytes, read accesses return the register values in place
+	 * @param	num		Number of bytes including the address byte
+	 */
+	void spiTransfer(uint8_t* const data, const uint8_t num) {
+		++numTransactions;
+		++transactionsSinceBurst;
+		numBytes += num;
+		bytesSinceBurst += num;
+		if (num == 0)
+			return;
+
+		const bool write = (data[0] & 0x80) != 0;
+		uint8_t address = data[0] & 0x7F;
+		data[0] = 0;
+		for (uint8_t i = 1; i < num; ++i) {
+			if (write) {
+				writeRegister(address, data[i]);
+			}
+			else {
+				data[i] = readRegister(address);
+			}
+			// The FIFO is accessed without address increment
+			if (address != 0)
+				address = (address + 1) & 0x7F;
+		}
+	}
+
+	/**
+	 * @brief Returns the content of a register
+	 *
+	 * @param	address		Register address
+	 */
+	uint8_t getRegister(const uint8_t address) const {
+		return regs[address & 0x7F];
+	}
+
+	/**
+	 * @brief Returns the mode bits of 'RegOpMode', e.g. 3 for TX mode
+	 */
+	uint8_t getMode() const {
+		return (regs[0x01] >> 2) & 0x07;
+	}
+
+	/**
+	 * @brief Returns the bit rate according to the bit rate registers in bit/s
+	 */
+	double getBitRate() const {
+		const uint16_t bitRateReg = ((uint16_t)regs[0x03] << 8) | regs[0x04];
+		return bitRateReg ? TSUNB_HOST_RFM69_FXOSC / bitRateReg : 0.0;
+	}
+
+	//! Reconstructed bursts in the order of their transmission
+	std::vector<EmulatedBurst> Bursts;
+
+	//! Total number of SPI transactions
+	uint64_t numTransactions;
+
+	//! Total number of SPI bytes including the address bytes
+	uint64_t numBytes;
+
+	//! Number of bytes written to the full FIFO
+	uint32_t numFifoOverflows;
+
+	//! Number of bursts, which were longer than the FIFO content
+	uint32_t numFifoUnderruns;
+
+private:
+	/**
+	 * @brief Returns the value of the 'RegFrf' registers
+	 */
+	uint32_t getRegFrf() const {
+		return ((uint32_t)regs[0x07] << 16) | ((uint32_t)regs[0x08] << 8) | regs[0x09];
+	}
+
+	/**
+	 * @brief Read access to a register
+	 */
+	uint8_t readRegister(const uint8_t address) {
+		if (address != 0)
+			return regs[address];
+
+		if (Fifo.empty())
+			return 0;
+		const uint8_t value = Fifo.front();
+		Fifo.erase(Fifo.begin());
+		return value;
+	}
+
+	/**
+	 * @brief Write access to a register
+	 */
+	void writeRegister(const uint8_t address, const uint8_t value) {
+		if (address == 0) {
+			if (getMode() == TSUNB_HOST_RFM69_MODE_TX && !Bursts.empty()) {
+				Bursts.back().data.push_back(value);
+			}
+			else if (Fifo.size() < TSUNB_HOST_RFM69_FIFO_SIZE) {
+				Fifo.push_back(value);
+			}
+			else {
+				++numFifoOverflows;
+			}
+			return;
+		}
+
+		const uint8_t prevMode = getMode();
+		regs[address] = value;
+
+		// A new frequency is applied after the LSB has been written
+		if (address == 0x09)
+			frf = getRegFrf();
+
+		if (address == 0x01) {
+			const uint8_t mode = getMode();
+			if (mode == TSUNB_HOST_RFM69_MODE_TX && prevMode != TSUNB_HOST_RFM69_MODE_TX) {
+				startBurst(prevMode);
+			}
+			else if (mode != TSUNB_HOST_RFM69_MODE_TX && prevMode == TSUNB_HOST_RFM69_MODE_TX) {
+				endBurst(mode);
+			}
+		}
+	}
+
+	/**
+	 * @brief Starts a new burst at the switch into TX mode
+	 *
+	 * @param	prevMode	Mode bits before the switch
+	 */
+	void startBurst(const uint8_t prevMode) {
+		EmulatedBurst Burst;
+		Burst.startTime = time;
+		Burst.endTime = time;
+		Burst.frf = frf;
+		Burst.paLevel = regs[0x11];
+		Burst.prevMode = prevMode;
+		Burst.nextMode = TSUNB_HOST_RFM69_MODE_TX;
+		Burst.numBits = 0;
+		Burst.data = Fifo;
+		Burst.numTransactions = 0;
+		Burst.numBytes = 0;
+		Fifo.clear();
+		Bursts.push_back(Burst);
+	}
+
+	/**
+	 * @brief Finishes the current burst at the switch out of TX mode
+	 *
+	 * @param	nextMode	Mode bits after the switch
+	 */
+	void endBurst(const uint8_t nextMode) {
+		EmulatedBurst& Burst = Bursts.back();
+		Burst.endTime = time;
+		Burst.nextMode = nextMode;
+		Burst.numBits = (uint16_t)llround((double)(Burst.endTime - Burst.startTime) / timeBase * getBitRate());
+		if (Burst.numBits > Burst.data.size() * 8)
+			++numFifoUnderruns;
+		Burst.numTransactions = transactionsSinceBurst;
+		Burst.numBytes = bytesSinceBurst;
+		transactionsSinceBurst = 0;
+		bytesSinceBurst = 0;
+	}
+
+	//! Number of time units per second
+	const double timeBase;
+
+	//! Register map, the FIFO at address 0 is stored separately
+	uint8_t regs[0x80];
+
+	//! Active frequency register value
+	uint32_t frf;
+
+	//! Current time
+	uint64_t time;
+
+	//! FIFO content
+	std::vector<uint8_t> Fifo;
+
+	//! Number of SPI transactions since the end of the last burst
+	uint32_t transactionsSinceBurst;
+
+	//! Number of SPI bytes since the end of the last burst
+	uint32_t bytesSinceBurst;
+};
+
+
+/**
+ * @brief Cpu_T implementation with a virtual timer and an emulated RFM69HW
+ *
+ * This class implements the platform interface of Trx::Rfm69hw on host systems. The SPI
+ * transactions are passed to an Rfm69Emulator and the symbol timer is emulated: timer 1 of the
+ * ATmega328p is modeled as 16 bit counter with the clock TIMER_CLOCK and a compare register.
+ * addTimerDelay() is identical to ArduinoTsUnb, i.e. the reconstructed burst times contain its
+ * rounding effects. waitTimer() returns immediately and advances the virtual time to the next
+ * compare match, so a telegram of several seconds is emulated within microseconds. It calls the
+ * timer callback like the interrupt of ArduinoTsUnb. Interrupt driven transmissions are
+ * emulated by calling runTimerEvent() until the transmission has finished.
+ *
+ * The times of the reconstructed bursts are given in timer ticks since the creation of the
+ * object. The virtual time keeps running between telegrams.
+ *
+ * @tparam	TIMER_CLOCK			Clock of the emulated timer in Hz (default is 16MHz / 256)
+ * @tparam	SYMBOL_RATE_MULT	TS-UNB symbol rate in multiples of 49.591064453125, see ArduinoTsUnb
+ */
+template <uint32_t TIMER_CLOCK = 62500, uint16_t SYMBOL_RATE_MULT = 48>
+class EmulatorCpu {
+public:
+	EmulatorCpu() : Emulator(TIMER_CLOCK), numWatchdogResets(0), numTimerErrors(0), numLowPowerWaits(0), now(0), counterStart(0),
+			compare(0), running(false), preciseTsUnbTimer(0), preciseTsUnbTimerFrac(0), callback(0), context(0) {
+	}
+
+	//! TS-UNB symbol rate in multiples of 49.591064453125, see ArduinoTsUnb
+	static constexpr uint16_t TS_UNB_SYMBOL_RATE_MULT = SYMBOL_RATE_MULT;
+
+	//! Bit duration in timer ticks, see ArduinoTsUnb
+	static constexpr float TS_UNB_BIT_DURATION = (double)TIMER_CLOCK / (49.591064453125 * (double)SYMBOL_RATE_MULT);
+
+	//! Bit duration in timer ticks as Q16.16 fixed point value, see ArduinoTsUnb
+	static constexpr uint32_t TS_UNB_BIT_DURATION_Q16 = (uint32_t)((double)TIMER_CLOCK / (49.591064453125 * (double)SYMBOL_RATE_MULT) * 65536.0 + 0.5);
+
+	//! Bit duration in timer ticks as Q16.32 fixed point value, see ArduinoTsUnb
+	static constexpr uint64_t TS_UNB_BIT_DURATION_Q32 = (uint64_t)((double)TIMER_CLOCK / (49.591064453125 * (double)SYMBOL_RATE_MULT) * 4294967296.0 + 0.5);
+
+	/**
+	 * @brief Init the timer, the counter restarts at zero
+	 */
+	void initTimer() {
+		preciseTsUnbTimer = 0;
+		preciseTsUnbTimerFrac = 0;
+		counterStart = now;
+		compare = 0;
+		running = false;
+	}
+
+	/**
+	 * @brief Start the timer
+	 */
+	void startTimer() {
+		running = true;
+	}
+
+	/**
+	 * @brief Stop the timer
+	 */
+	void stopTimer() {
+		running = false;
+		counterStart = now;
+	}
+
+	/**
+	 * @brief Add the counter compare value for the next interrupt
+	 *
+	 * @param count Delay in TX symbols
+	 */
+	void addTimerDelay(const int32_t count) {
+		const uint32_t frac = (uint32_t)count * (uint16_t)TS_UNB_BIT_DURATION_Q32 + preciseTsUnbTimerFrac;
+		preciseTsUnbTimerFrac = (uint16_t)frac;
+		preciseTsUnbTimer += (uint32_t)count * (uint32_t)(TS_UNB_BIT_DURATION_Q32 >> 16) + (frac >> 16);
+		compare = (uint16_t)((preciseTsUnbTimer + 0x8000u) >> 16);
+	}
+
+	/**
+	 * @brief Set the absolute counter compare value for the next interrupt
+	 *
+	 * @param timerCompareMatch Timer value of the next interrupt in timer ticks
+	 */
+	void setTimerCompare(const uint16_t timerCompareMatch) {
+		compare = timerCompareMatch;
+	}
+
+	/**
+	 * @brief Advances the virtual time to the next compare match
+	 *
+	 * @param	lowPower	Low power wait, only counted in numLowPowerWaits
+	 */
+	void waitTimer(const bool lowPower = false) {
+		if (lowPower)
+			++numLowPowerWaits;
+		runTimerEvent();
+	}
+
+	/**
+	 * @brief Advances the virtual time to the next compare match and calls the timer callback
+	 *
+	 * @return	false if the timer is not running, i.e. the call would block forever on the target
+	 */
+	bool runTimerEvent() {
+		if (!running) {
+			++numTimerErrors;
+			return false;
+		}
+
+		const uint16_t counter = (uint16_t)(now - counterStart);
+		uint32_t delta = (uint16_t)(compare - counter);
+		if (delta == 0)
+			delta = 0x10000;
+		now += delta;
+
+		if (callback)
+			callback(context);
+		return true;
+	}
+
+	/**
+	 * @brief Returns the current value of the 16 bit counter
+	 */
+	uint16_t getTimerCount() const {
+		return (uint16_t)(now - counterStart);
+	}
+
+	/**
+	 * @brief Returns the current compare value
+	 */
+	uint16_t getTimerCompare() const {
+		return compare;
+	}
+
+	/**
+	 * @brief Set the function called at every compare match
+	 *
+	 * @param callback_ Function called at every compare match, null pointer to disable
+	 * @param context_  Context passed to the \p callback_
+	 */
+	void setTimerCallback(void (* const callback_)(void*), void* const context_) {
+		callback = callback_;
+		context = context_;
+	}
+
+	void spiInit(void) {
+	}
+
+	void spiDeinit(void) {
+	}
+
+	/**
+	 * @brief Sends multiple bytes to the emulator
+	 */
+	void spiSend(const uint8_t* const dataOut, const uint8_t numBytes) {
+		uint8_t data[256];
+		for (uint8_t i = 0; i < numBytes; ++i) {
+			data[i] = dataOut[i];
+		}
+		Emulator.setTime(now);
+		Emulator.spiTransfer(data, numBytes);
+	}
+
+	/**
+	 * @brief Writes multiple bytes to a single register address within one transaction
+	 */
+	void spiSendBurst(const uint8_t address, const uint8_t* const dataOut, const uint8_t numBytes) {
+		uint8_t data[256];
+		data[0] = address;
+		for (uint8_t i = 0; i < numBytes && i < 255; ++i) {
+			data[i + 1] = dataOut[i];
+		}
+		Emulator.setTime(now);
+		Emulator.spiTransfer(data, numBytes < 255 ? numBytes + 1 : 255);
+	}
+
+	/**
+	 * @brief Sends and receives multiple bytes
+	 */
+	void spiSendReceive(uint8_t* const dataInOut, const uint8_t numBytes) {
+		Emulator.setTime(now);
+		Emulator.spiTransfer(dataInOut, numBytes);
+	}
+
+	void resetWatchdog() {
+		++numWatchdogResets;
+	}
+
+	/**
+	 * @brief Returns the virtual time in timer ticks
+	 */
+	uint64_t getTime() const {
+		return now;
+	}
+
+	/**
+	 * @brief Advances the virtual time, e.g. to emulate the time between telegrams
+	 *
+	 * @param ticks Number of timer ticks
+	 */
+	void advanceTime(const uint64_t ticks) {
+		now += ticks;
+	}
+
+	//! Emulated transceiver, the time unit of the reconstructed bursts is one timer tick
+	Rfm69Emulator Emulator;
+
+	//! Number of watchdog resets
+	uint32_t numWatchdogResets;
+
+	//! Number of waits for a stopped timer
+	uint32_t numTimerErrors;
+
+	//! Number of low power waits
+	uint32_t numLowPowerWaits;
+
+private:
+	//! Virtual time in timer ticks
+	uint64_t now;
+
+	//! Virtual time at which the 16 bit counter was zero
+	uint64_t counterStart;
+
+	//! Compare register
+	uint16_t compare;
+
+	//! True if the timer is running
+	bool running;
+
+	//! Precise state of the timer as Q16.16 fixed point value, see ArduinoTsUnb
+	uint32_t preciseTsUnbTimer;
+
+	//! Additional fractional bits of the precise state of the timer
+	uint16_t preciseTsUnbTimerFrac;
+
+	//! Function called at every compare match
+	void (*callback)(void*);
+
+	//! Context passed to callback
+	void* context;
+};
+
+
+};	// namespace Host
+};	// namespace TsUnbLib
+
+#endif	// TSUNB_HOST_RFM69_EMULATOR_H_
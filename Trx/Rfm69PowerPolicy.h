@@ -0,0 +1,200 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+/**
+ * @brief	Power state policy of the RFM69HW between radio bursts
+ *
+ * @file	Rfm69PowerPolicy.h
+ *
+ */
+
+
+#ifndef RFM69_POWER_POLICY_H_
+#define RFM69_POWER_POLICY_H_
+
+#include <stdint.h>
+
+namespace TsUnbLib {
+namespace Trx {
+
+
+//! Crystal oscillator wake-up time of the RFM69HW in us (sleep to standby, datasheet TS_OSC, conservative)
+#define RFM69_TS_OSC_US				500
+
+//! Frequency synthesizer wake-up time of the RFM69HW in us (standby to FS, datasheet TS_FS, conservative)
+#define RFM69_TS_FS_US				80
+
+//! Supply current of the RFM69HW in sleep mode in nA
+#define RFM69_IDD_SLEEP_NA			100
+
+//! Supply current of the RFM69HW in standby mode in nA
+#define RFM69_IDD_STDBY_NA			1250000
+
+//! Supply current of the RFM69HW in FS mode in nA
+#define RFM69_IDD_FS_NA				9000000
+
+//! Minimum wait in symbols before the low power wait of the CPU is used
+#define RFM69_CPU_LOW_POWER_MIN_SYMBOLS	8
+
+
+/**
+ * @brief Power state policy of the RFM69HW and the CPU between radio bursts
+ *
+ * This class decides per gap between two radio bursts in which state the transmitter and the
+ * CPU wait. The decisions are based on the wake-up times and the supply currents of the
+ * RFM69HW:
+ * - The transmitter is woken up WAKE_SYMBOLS symbols before a burst, which is the shortest lead
+ *   covering the FIFO load (LOAD_US), the oscillator start-up and the PLL lock from sleep mode.
+ *   The wake up must not start before END_SYMBOLS after the end of the previous burst.
+ * - Between the bursts the transmitter is kept in standby mode instead of sleep mode only if
+ *   the gap is shorter than the break even time, at which the standby current equals the
+ *   charge of the oscillator start-up. This is about RFM69_TS_OSC_US, i.e. much less than the
+ *   shortest gap of a TS-UNB telegram, hence sleep mode is used for all standard gaps.
+ * - The CPU uses the low power wait (e.g. idle mode with the unused peripherals switched off)
+ *   for gaps of at least RFM69_CPU_LOW_POWER_MIN_SYMBOLS symbols, which are followed by the
+ *   non-critical FIFO load. The waits in front of the switch into and out of TX mode use the
+ *   normal wait to keep the wake-up latency minimal.
+ *
+ * The timer of the symbol clock has to keep running while the CPU sleeps. For the ATmega328p
+ * this limits the CPU to the idle mode, see ArduinoTsUnb::waitTimer().
+ *
+ * @tparam	SYMBOL_RATE_MULT	TS-UNB symbol rate in multiples of 49.591064453125, has to match the Cpu_T
+ * @tparam	LOAD_US				Maximum time for the calculation of the frequency and the FIFO load in us
+ */
+template <uint16_t SYMBOL_RATE_MULT = 48, uint16_t LOAD_US = 150>
+class Rfm69PowerPolicy {
+public:
+	//! TS-UNB symbol rate in multiples of 49.591064453125, has to match Cpu_T::TS_UNB_SYMBOL_RATE_MULT
+	static constexpr uint16_t TS_UNB_SYMBOL_RATE_MULT = SYMBOL_RATE_MULT;
+
+	//! Symbol duration in ns
+	static constexpr uint32_t SYMBOL_NS = (uint32_t)(4096000000000ULL / (203125ULL * SYMBOL_RATE_MULT));
+
+	//! Number of symbols the transmitter is woken up before a burst
+	static constexpr uint16_t WAKE_SYMBOLS = (uint16_t)(((uint32_t)LOAD_US + RFM69_TS_OSC_US + RFM69_TS_FS_US) * 1000UL / SYMBOL_NS + 1);
+
+	//! Number of symbols after a burst for the switch out of TX mode and setting the next timer compare value
+	static constexpr uint16_t END_SYMBOLS = 1;
+
+	//! Gap in us below which the standby mode requires less charge than the sleep mode
+	static constexpr uint32_t STDBY_BREAK_EVEN_US = (uint32_t)((uint64_t)RFM69_IDD_STDBY_NA * RFM69_TS_OSC_US / (RFM69_IDD_STDBY_NA - RFM69_IDD_SLEEP_NA));
+
+	/**
+	 * @brief Returns true if the transmitter shall be kept in standby mode during the gap
+	 *
+	 * @param	gapSymbols	Time in symbols from the end of a burst to the wake up before the next burst
+	 */
+	static bool useStandby(const int16_t gapSymbols) {
+		return gapSymbols > 0 && (uint32_t)gapSymbols * SYMBOL_NS < STDBY_BREAK_EVEN_US * 1000UL;
+	}
+
+	/**
+	 * @brief Returns true if the CPU shall use the low power wait during the gap
+	 *
+	 * @param	gapSymbols	Time in symbols until the next timer event, which must not be time critical
+	 */
+	static bool useCpuLowPower(const int16_t gapSymbols) {
+		return gapSymbols >= RFM69_CPU_LOW_POWER_MIN_SYMBOLS;
+	}
+
+	/**
+	 * @brief Returns the charge of the transmitter during a gap in nC
+	 *
+	 * The charge of the oscillator start-up is included in case of the sleep mode.
+	 *
+	 * @param	gapSymbols	Time in symbols from the end of a burst to the wake up before the next burst
+	 * @param	standby		Use of the standby mode instead of the sleep mode
+	 */
+	static uint32_t getGapCharge(const uint16_t gapSymbols, const bool standby) {
+		const uint64_t gapNs = (uint64_t)gapSymbols * SYMBOL_NS;
+		if (standby)
+			return (uint32_t)(gapNs * RFM69_IDD_STDBY_NA / 1000000000ULL);
+		return (uint32_t)((gapNs * RFM69_IDD_SLEEP_NA + (uint64_t)RFM69_TS_OSC_US * 1000ULL * RFM69_IDD_STDBY_NA) / 1000000000ULL);
+	}
+
+	/**
+	 * @brief Returns the charge of the transmitter in FS mode in front of a burst in nC
+	 *
+	 * @param	wakeSymbols	Number of symbols the transmitter is woken up before the burst
+	 */
+	static uint32_t getWakeCharge(const uint16_t wakeSymbols) {
+		const uint64_t fsNs = (uint64_t)wakeSymbols * SYMBOL_NS - (uint64_t)(LOAD_US + RFM69_TS_OSC_US) * 1000ULL;
+		return (uint32_t)(fsNs * RFM69_IDD_FS_NA / 1000000000ULL);
+	}
+};
+
+
+};	// namespace Trx
+};	// namespace TsUnbLib
+
+#endif	/* RFM69_POWER_POLICY_H_ */
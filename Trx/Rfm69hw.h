@@ -86,6 +86,10 @@ ks-contracts@iis.fraunhofer.de
 #include <stdint.h>
 
 #include "../Utils/BitAccess.h"
+#include "Rfm69PowerPolicy.h"
+#ifdef TSUNB_TIMING_AUDIT
+#include "TimingAudit.h"
+#endif
 
 namespace TsUnbLib {
 namespace Trx {
@@ -96,6 +100,9 @@ namespace Trx {
 //! Register setting for continuous mode without bit synchronizer 
 #define RFM69_CONT_FSK_NOSHAPING	0x60
 
+//! Write access to the 'RegFifo' register
+#define RFM69_WRITE_FIFO			0x80
+
 //! Write access to the 'RegFdevMsb' register
 #define RFM69_WRITE_FDEV			0x85
 
@@ -109,14 +116,38 @@ namespace Trx {
 #define RFM69_MODE_SLEEP			0x00
 
 //! Register value for standby mode
-#define RFM69_MODE_STDBY			0x01
+#define RFM69_MODE_STDBY			0x04
 
 //! Register value for frequency synthesizer mode
-#define RFM69_MODE_FS				0x02
+#define RFM69_MODE_FS				0x08
 
 //!brief Set transceiver into transmitter mode
 #define RFM69_MODE_TX				0x0C
 
+//! Shadow register flag for 'RegFrfMsb', 'RegFrfMid' and 'RegFrfLsb'
+#define RFM69_SHADOW_FRF			0x01
+
+//! Shadow register flag for 'RegPaLevel'
+#define RFM69_SHADOW_PA_LEVEL		0x02
+
+//! Shadow register flag for 'RegOpMode'
+#define RFM69_SHADOW_MODE			0x04
+
+//! Flag for a valid register checksum of the retained state
+#define RFM69_SHADOW_CHECKSUM		0x08
+
+//! First register of the first checksum window ('RegOpMode' to 'RegOcp', includes all shadow registers)
+#define RFM69_CHECKSUM_ADDR_A		0x01
+
+//! Number of registers of the first checksum window
+#define RFM69_CHECKSUM_LEN_A		19
+
+//! First register of the second checksum window ('RegPreambleMsb' to 'RegFifoThresh')
+#define RFM69_CHECKSUM_ADDR_B		0x2c
+
+//! Number of registers of the second checksum window
+#define RFM69_CHECKSUM_LEN_B		17
+
 //! Write access to 'RegPaLevel' register
 #define RFM69_WRITE_PA_LEVEL		0x91
 
@@ -178,20 +209,54 @@ namespace Trx {
  * At an early stage in the program the init() method shall be called. It brings the device into the sleep
  * mode to save energy. It is not part of the constructor to allow the user to start a watchdog before
  * calling the init() method.
+ *
+ * The transmission of radio bursts generated on demand is implemented as a state machine in transmitStep(),
+ * which is called at every timer event. The method transmit() runs it in a blocking loop, whereas
+ * beginTransmit() runs it within the timer interrupt and returns immediately.
+ *
+ * Nodes, which transmit often, may enable the retained state using setRetainedState(). Then the SPI
+ * interface stays initialized after a transmission and wake() validates the register contents of the
+ * RFM69HW with a checksum of two register reads, so that the complete initialization is only
+ * repeated after a reset or a mismatch.
+ *
+ * The template class PowerPolicy_T defines the wake-up time before a burst and the power states of the
+ * transmitter and the CPU between the bursts, see Rfm69PowerPolicy. Its symbol rate has to match the
+ * TS_UNB_SYMBOL_RATE_MULT of the Cpu_T, which is used by default.
  * 
  * @tparam		Cpu_T			Plattform depended implementation
  * @tparam		BOOST_PIN		Use of the PA BOOST pin (depends on the hardware, default is off)
  * @tparam		F_DEV			Frequency deviation resgister setting
  * @tparam		RadioBurst_T	Radio burst class
+ * @tparam		PowerPolicy_T	Power state policy between the radio bursts
  *
  */
 template <class Cpu_T, bool BOOST_PIN = false, uint32_t F_DEV = 10, 
-class RadioBurst_T = TsUnb::RadioBurst<> >
+class RadioBurst_T = TsUnb::RadioBurst<>, class PowerPolicy_T = Rfm69PowerPolicy<Cpu_T::TS_UNB_SYMBOL_RATE_MULT> >
 class Rfm69hw {
+	static_assert(PowerPolicy_T::TS_UNB_SYMBOL_RATE_MULT == Cpu_T::TS_UNB_SYMBOL_RATE_MULT,
+			"The symbol rate of the power policy must match the Cpu_T");
+	static_assert(PowerPolicy_T::WAKE_SYMBOLS <= 4 + 2, "The wake up before the first burst must not exceed the initialization time");
+
 public:
+	//! Minimum time in symbols between the end of a burst and the start of the next burst of a schedule
+	static constexpr uint16_t SCHEDULE_GUARD_SYMBOLS = PowerPolicy_T::WAKE_SYMBOLS + PowerPolicy_T::END_SYMBOLS;
+
 	Cpu_T Cpu;
+
+#ifdef TSUNB_TIMING_AUDIT
+	//! Timing audit of the last transmission using transmit() or beginTransmit() with a burst source
+	TimingAudit<TSUNB_TIMING_AUDIT> Audit;
+#endif
+
 	Rfm69hw() {
 		txPower = 13;
+		txState = TX_STATE_IDLE;
+		txInterruptDriven = false;
+		txCancel = false;
+		txCpuLowPower = false;
+		regValid = 0;
+		retainState = false;
+		spiActive = false;
 	}
 
 	~Rfm69hw() {
@@ -210,7 +275,7 @@ public:
 	 */
 	int16_t init(void) {
 		// TODO check if chips is actually present and return negative value in case of error
-		Cpu.spiInit();
+		beginSpi();
 
 		// Read register 0x0c and check if 0x02, if no there is no chip
 		{
@@ -218,7 +283,8 @@ public:
 			Cpu.spiSendReceive(spiData, 2);
 			if (spiData[1] != 0x02) {
 				// Chip not found!
-				Cpu.spiDeinit();   
+				Cpu.spiDeinit();
+				spiActive = false;
 
 				return -1;
 			}
@@ -227,6 +293,7 @@ public:
 		/*
 		 * Initialize with presets
 		 */
+		invalidateRegisterCache();
 		const uint8_t presets[] = RFM69_CONFIG_ARRAY;
 		uint8_t idx = 0;
 		while (presets[idx] != 0) {
@@ -235,11 +302,53 @@ public:
 		}
 		setMode(RFM69_MODE_SLEEP);
 
-		Cpu.spiDeinit();
+		endSpi();
 
 		return 0;
 	}
 
+	/**
+	 * @brief Wake up method for the retained state
+	 *
+	 * This method shall be called after a sleep of the CPU, e.g. using wdtSleep(), if the retained
+	 * state is enabled. It reads the registers of the RFM69HW and compares their checksum with the
+	 * checksum after the last access. Only in case of a mismatch, e.g. after a brown-out of the
+	 * module, or if no checksum is available, e.g. after a reset of the CPU, init() is called.
+	 *
+	 * @return 0 if the state has been retained, 1 if init() has been called, negative value in case of errors
+	 */
+	int16_t wake(void) {
+		if (txState != TX_STATE_IDLE)
+			return -1;
+
+		if (regValid & RFM69_SHADOW_CHECKSUM) {
+			beginSpi();
+			if (readRegisterChecksum() == regChecksum)
+				return 0;
+		}
+
+		const int16_t result = init();
+		return result != 0 ? result : 1;
+	}
+
+	/**
+	 * @brief Enables or disables the retained state
+	 *
+	 * In the retained state the SPI interface is not deinitialized after init() and after a
+	 * transmission and a checksum of the registers is stored for wake(). It shall be enabled
+	 * before init() is called. Disabling the retained state deinitializes the SPI interface.
+	 *
+	 * @param	retain		Enable the retained state
+	 */
+	void setRetainedState(const bool retain) {
+		retainState = retain;
+		regValid &= ~RFM69_SHADOW_CHECKSUM;
+		if (!retain && spiActive) {
+			Cpu.spiDeinit();
+			spiActive = false;
+		}
+	}
+
 	/**
 	 * \brief	Transmit method
 	 * 
@@ -253,71 +362,306 @@ public:
 	 * \return 0 if OK, negative falue in case of errors
 	 */
 	int16_t transmit(const RadioBurst_T* const Bursts, const uint16_t numTxBursts, const uint32_t frequency) {
-		Cpu.spiInit();
+		TsUnb::RadioBurstArray<RadioBurst_T> Source(Bursts, numTxBursts);
+		return transmit(Source, frequency);
+	}
+
+	/**
+	 * \brief	Transmit method for radio bursts generated on demand
+	 *
+	 * This method transmits the radio bursts returned by the \p Source one after another
+	 * with the frequency offset given in \p frequency. Only a single radio burst is kept in
+	 * memory. The next radio burst is requested from the source directly after the transmission
+	 * of the current radio burst, i.e. the source can encode it during the gap between the bursts.
+	 *
+	 * The template class BurstSource_T has to offer the method bool getNextRadioBurst(RadioBurst_T* const),
+	 * which returns false if there are no more radio bursts, e.g. the streaming encoder of the PHY.
+	 *
+	 * \param	Source		Source of the radio bursts
+	 * \param	frequency	Frequency f0 of the transmission (module dependent in register values)
+	 *
+	 * \return 0 if OK, negative falue in case of errors
+	 */
+	template <class BurstSource_T>
+	int16_t transmit(BurstSource_T& Source, const uint32_t frequency) {
+		if (txState != TX_STATE_IDLE)
+			return -1;
+
+		txInterruptDriven = false;
+		startTransmit(Source, frequency);
+
+		while (txState != TX_STATE_IDLE) {
+			Cpu.resetWatchdog();
+			Cpu.waitTimer(txCpuLowPower);
+			transmitStep();
+		}
+
+		return 0;
+	}
+
+	/**
+	 * \brief	Starts an interrupt driven transmission of radio bursts generated on demand
+	 *
+	 * This method starts the transmission of the radio bursts returned by the \p Source and
+	 * returns immediately. The burst sequencing is performed by the timer interrupt of the
+	 * Cpu_T, which calls transmitStep() at every timer event. The timing is identical to the
+	 * blocking transmit() method. The end of the transmission can be polled using isTransmitting().
+	 *
+	 * The \p Source must remain valid until the transmission has finished. The next radio burst
+	 * is requested from the \p Source within the interrupt after the end of the current burst.
+	 * The SPI interface must not be used by other code during the transmission, unless it is
+	 * protected against the timer interrupt.
+	 *
+	 * The Cpu_T has to offer the method setTimerCallback(void (*)(void*), void*). The callback is
+	 * removed again at the end of the transmission. Since transmitStep() is then called within the
+	 * interrupt, the timer and SPI methods of the Cpu_T must preserve the interrupt state.
+	 *
+	 * \param	Source		Source of the radio bursts
+	 * \param	frequency	Frequency f0 of the transmission (module dependent in register values)
+	 *
+	 * \return 0 if OK, negative value if a transmission is still active
+	 */
+	template <class BurstSource_T>
+	int16_t beginTransmit(BurstSource_T& Source, const uint32_t frequency) {
+		if (txState != TX_STATE_IDLE)
+			return -1;
+
+		txInterruptDriven = true;
+		Cpu.setTimerCallback(&Rfm69hw::timerCallback, this);
+		startTransmit(Source, frequency);
+
+		return 0;
+	}
+
+	/**
+	 * \brief	Returns true while a transmission is active
+	 */
+	bool isTransmitting(void) const {
+		return txState != TX_STATE_IDLE;
+	}
+
+	/**
+	 * \brief	Aborts an interrupt driven transmission
+	 *
+	 * The transmission ends at the next timer event, which is not within a radio burst, i.e. a
+	 * radio burst, which is currently transmitted, is completed. No further radio burst is requested
+	 * from the source. isTransmitting() returns true until the transmitter is in sleep mode.
+	 */
+	void cancelTransmit(void) {
+		if (txState != TX_STATE_IDLE)
+			txCancel = true;
+	}
+
+	/**
+	 * \brief	Performs the transmitter actions of a single timer event
+	 *
+	 * This method is the state machine of the burst sequencing. It performs all actions which
+	 * are due at the current timer event and programs the next timer event, e.g. loading the
+	 * FIFO and switching to FS mode PowerPolicy_T::WAKE_SYMBOLS before a burst, switching to TX
+	 * mode at the start of the burst and switching to sleep or standby mode at the end of the
+	 * burst. The SPI data of the next burst is prepared in the gap after the end of the burst,
+	 * so that the load before the burst only transfers it.
+	 */
+	void transmitStep(void) {
+		// A cancel takes effect at the first timer event after the current burst
+		if (txCancel && txState != TX_STATE_END) {
+			finishTransmit();
+			return;
+		}
+
+		switch (txState) {
+		case TX_STATE_LOAD:
+			// Special handling in case of zero length bursts
+			if (txBurst.getBurstLength() == 0) {
+				const int16_t T_RB = (int16_t)txBurst.get_T_RB();
+#ifdef TSUNB_TIMING_AUDIT
+				Audit.addSymbols(T_RB);
+#endif
+				if (txNextBurst(txSource, &txBurst)) {
+					prepareBurst();
+					Cpu.addTimerDelay(T_RB);
+					txCpuLowPower = PowerPolicy_T::useCpuLowPower(T_RB);
+				}
+				else {
+					finishTransmit();
+				}
+				break;
+			}
+
+			loadBurst();
+
+			Cpu.addTimerDelay(PowerPolicy_T::WAKE_SYMBOLS);
+			txState = TX_STATE_START;
+			txCpuLowPower = false;
+#ifdef TSUNB_TIMING_AUDIT
+			Audit.recordLoaded(Cpu.getTimerCount(), Cpu.getTimerCompare());
+#endif
+			break;
+
+		case TX_STATE_START:
+			startBurst();
+
+			Cpu.addTimerDelay(txBurst.getBurstLength());
+			txState = TX_STATE_END;
+			break;
+
+		case TX_STATE_END: {
+			const int16_t burstLength = txBurst.getBurstLength();
+			const int16_t T_RB = (int16_t)txBurst.get_T_RB();
+			const int16_t gap = T_RB - burstLength - PowerPolicy_T::WAKE_SYMBOLS;
+			endBurst(gap);
+			if (txCancel) {
+				finishTransmit();
+				break;
+			}
+
+			/*
+			 * If we are not in the last burst wait for the next burst to start.
+			 * If we are in the last burst we do not have to restart the counter again.
+			 * 
+			 * We wake up PowerPolicy_T::WAKE_SYMBOLS before the new burst starts. This gives us enough
+			 * time to shift the data into the FIFO and to lock the PLL before the next transmission starts.
+			 */
+#ifdef TSUNB_TIMING_AUDIT
+			Audit.addSymbols(T_RB);
+#endif
+			if (txNextBurst(txSource, &txBurst)) {
+				prepareBurst();
+				Cpu.addTimerDelay(gap);
+				txState = TX_STATE_LOAD;
+				txCpuLowPower = PowerPolicy_T::useCpuLowPower(gap);
+			}
+			else {
+				finishTransmit();
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+
+	/**
+	 * \brief	Transmit method using a precalculated transmission schedule
+	 *
+	 * This method transmits the complete packet contained in \p Bursts using the absolute
+	 * start times and frequencies of the \p Schedule, e.g. calculated using the encodeSchedule()
+	 * method of the PHY with Cpu_T::TS_UNB_BIT_DURATION_Q16 or the interleaved schedule of several
+	 * telegrams of TsUnb::TxScheduler. All timer compare values and
+	 * frequency register values are available before the transmission starts, i.e. no
+	 * calculations are required between the timer events. The bursts are loaded, started and
+	 * ended with the same methods as in transmitStep(), i.e. the power policy and the timing
+	 * audit apply as well.
+	 *
+	 * The start times of consecutive bursts must differ by at least the burst length plus
+	 * SCHEDULE_GUARD_SYMBOLS and by less than 2^15 timer ticks, otherwise nothing is
+	 * transmitted. If a timer event is nevertheless missed, e.g. because the CPU has been blocked
+	 * by other interrupts, the transmission is aborted instead of waiting for a wrap around
+	 * of the timer.
+	 *
+	 * \param	Bursts		Pointer to burst data
+	 * \param	Schedule	Pointer to the transmission schedule with one entry per burst
+	 * \param	numTxBursts	Number of transmit bursts, nothing is transmitted if 0
+	 *
+	 * \return 0 if OK, -1 if a transmission is active, -2 for an invalid schedule, -3 if a timer event has been missed
+	 */
+	int16_t transmit(const RadioBurst_T* const Bursts, const TsUnb::TxScheduleEntry* const Schedule,
+			const uint16_t numTxBursts) {
+		if (txState != TX_STATE_IDLE)
+			return -1;
+		if (numTxBursts == 0)
+			return 0;
+
+		const uint16_t minDistance = symbolsToTicks(RadioBurst_T::BURST_LENGTH + SCHEDULE_GUARD_SYMBOLS);
+		for (uint16_t burstIdx = 1; burstIdx < numTxBursts; ++burstIdx) {
+			const uint16_t distance = Schedule[burstIdx].startTick - Schedule[burstIdx - 1].startTick;
+			if (distance < minDistance || distance >= 0x8000u)
+				return -2;
+		}
+
+		// Give the system the time of four bits to initialize everything (approx. 10ms), the first
+		// burst starts two bits later
+		const uint16_t startTicks = symbolsToTicks(4 + 2);
+		const uint16_t wakeUpTicks = symbolsToTicks(PowerPolicy_T::WAKE_SYMBOLS);
+		const uint16_t burstTicks = symbolsToTicks(RadioBurst_T::BURST_LENGTH);
+
+		beginSpi();
 
 		Cpu.initTimer();
 		setTxPwrReg(txPower);
+#ifdef TSUNB_TIMING_AUDIT
+		Audit.start(Cpu_T::TS_UNB_BIT_DURATION_Q16);
+#endif
 
-		// Give the system the time of four bits to initialize everything (approx. 10ms)
-		Cpu.addTimerDelay(4);
+		Cpu.setTimerCompare(startTicks + Schedule[0].startTick - wakeUpTicks);
 		Cpu.startTimer();
+		bool cpuLowPower = false;
+		int16_t result = 0;
 
 		for (uint16_t burstIdx = 0; burstIdx < numTxBursts;	++burstIdx) {
 			Cpu.resetWatchdog();
 
+			const uint16_t txTick = startTicks + Schedule[burstIdx].startTick;
+			const bool lastBurst = burstIdx + 1 == numTxBursts;
+			const uint16_t nextWakeTick = lastBurst ? 0 : startTicks + Schedule[burstIdx + 1].startTick - wakeUpTicks;
+
 			// Special handling in case of zero length bursts
 			if (Bursts[burstIdx].getBurstLength() == 0) {
-				Cpu.waitTimer();
-				if (burstIdx + 1 < numTxBursts) {
-					Cpu.addTimerDelay((int16_t)Bursts[burstIdx].get_T_RB() - Bursts[burstIdx].getBurstLength());
+				Cpu.waitTimer(cpuLowPower);
+				if (!lastBurst) {
+#ifdef TSUNB_TIMING_AUDIT
+					Audit.addTicks(Schedule[burstIdx + 1].startTick - Schedule[burstIdx].startTick);
+#endif
+					if (!setScheduledCompare(nextWakeTick)) {
+						result = -3;
+						break;
+					}
+					cpuLowPower = PowerPolicy_T::useCpuLowPower(ticksToSymbols(nextWakeTick - txTick + wakeUpTicks));
 				}
 				continue;
 			}
 
-			const uint32_t cFrequency = (uint32_t) Bursts[burstIdx].getCarrierOffset();
-			const uint32_t modFreq = frequency + cFrequency;
-			Cpu.waitTimer();
-			setFrequencyReg(modFreq);
-
-			const uint8_t* burstData = Bursts[burstIdx].getBurst();
-			for (uint8_t byteIdx = 0; byteIdx < Bursts[burstIdx].getBurstLengthBytes(); ++byteIdx) {
-				uint8_t data[2] = {0x80, burstData[byteIdx]};
-				Cpu.spiSend(data, 2);
-			}
+			txBurst = Bursts[burstIdx];
+			prepareBurst(Schedule[burstIdx].freqReg);
+			Cpu.waitTimer(cpuLowPower);
+			loadBurst();
 
-			// Add one dummy byte, if this byte is actually transmitted, the TX switches itself into sleep mode 
-			// because we did not set  the sleep command
-			{
-				uint8_t data[2] = {0x80, 0};
-				Cpu.spiSend(data, 2);
+			if (!setScheduledCompare(txTick)) {
+				result = -3;
+				break;
 			}
-			setMode(RFM69_MODE_FS);
-
-			Cpu.addTimerDelay(2);
+#ifdef TSUNB_TIMING_AUDIT
+			Audit.recordLoaded(Cpu.getTimerCount(), Cpu.getTimerCompare());
+#endif
 			Cpu.waitTimer();
-			setMode(RFM69_MODE_TX);
+			startBurst();
 
-			Cpu.addTimerDelay(Bursts[burstIdx].getBurstLength());
+			if (!setScheduledCompare(txTick + burstTicks)) {
+				result = -3;
+				break;
+			}
 			Cpu.waitTimer();
-			setMode(RFM69_MODE_SLEEP);
-
-			/*
-			 * If we are not in the last burst wait for the next burst to start.
-			 * If we are in the last burst we do not have to restart the counter again.
-			 * 
-			 * We wake up 2 bits before the new burst starts. This gives us enough time to shift the
-			 * data into the FIFO before the next transmission starts.
-			 */
-			if (burstIdx + 1 < numTxBursts) {
-				Cpu.addTimerDelay((int16_t)Bursts[burstIdx].get_T_RB() - Bursts[burstIdx].getBurstLength() - 2);
+			if (lastBurst)
+				break;
+
+			// We wake up PowerPolicy_T::WAKE_SYMBOLS before the next burst starts
+			const int16_t gap = ticksToSymbols(nextWakeTick - txTick - burstTicks);
+			endBurst(gap);
+#ifdef TSUNB_TIMING_AUDIT
+			Audit.addTicks(Schedule[burstIdx + 1].startTick - Schedule[burstIdx].startTick);
+#endif
+			if (!setScheduledCompare(nextWakeTick)) {
+				result = -3;
+				break;
 			}
+			cpuLowPower = PowerPolicy_T::useCpuLowPower(gap);
 		}
-		//Cpu.waitTimer();
 		setMode(RFM69_MODE_SLEEP);
 		Cpu.stopTimer();
-		Cpu.spiDeinit();
+		endSpi();
 
-		return 0;
+		return result;
 	}
 
 	/**
@@ -332,29 +676,287 @@ public:
 		txPower = power;
 	}
 
+	/**
+	 * @brief Invalidates the register shadow
+	 *
+	 * The driver keeps a copy of the frequency, PA level and mode registers and only writes
+	 * registers, which differ from this copy. This method must be called if the register
+	 * contents of the RFM69HW may have changed otherwise, e.g. after a power cycle or a reset
+	 * of the module. The next write of each register is then performed unconditionally and
+	 * the next wake() calls init().
+	 */
+	void invalidateRegisterCache(void) {
+		regValid = 0;
+	}
+
 private:
 
+	//! States of the burst sequencing
+	enum TxState {
+		TX_STATE_IDLE,		//!< No transmission active
+		TX_STATE_LOAD,		//!< Load the FIFO and enter FS mode at the next timer event
+		TX_STATE_START,		//!< Enter TX mode at the next timer event
+		TX_STATE_END		//!< Enter sleep mode at the next timer event
+	};
+
+	/**
+	 * @brief Requests the next radio burst from a source of type BurstSource_T
+	 */
+	template <class BurstSource_T>
+	static bool getNextRadioBurst(void* const Source, RadioBurst_T* const Burst) {
+		return static_cast<BurstSource_T*>(Source)->getNextRadioBurst(Burst);
+	}
+
+	/**
+	 * @brief Timer callback for the interrupt driven transmission
+	 */
+	static void timerCallback(void* const context) {
+		Rfm69hw* const Trx = static_cast<Rfm69hw*>(context);
+		if (Trx->txInterruptDriven)
+			Trx->transmitStep();
+	}
+
 	/**
-	 * @brief Set frequency register
+	 * @brief Prepares the transmitter and starts the timer for the first radio burst
+	 *
+	 * @param	Source		Source of the radio bursts
+	 * @param	frequency	Frequency f0 of the transmission (module dependent in register values)
+	 */
+	template <class BurstSource_T>
+	void startTransmit(BurstSource_T& Source, const uint32_t frequency) {
+		txSource = &Source;
+		txNextBurst = &Rfm69hw::getNextRadioBurst<BurstSource_T>;
+		txFrequency = frequency;
+		txCancel = false;
+		const bool burstValid = Source.getNextRadioBurst(&txBurst);
+		if (burstValid)
+			prepareBurst();
+
+		beginSpi();
+
+		Cpu.initTimer();
+		setTxPwrReg(txPower);
+#ifdef TSUNB_TIMING_AUDIT
+		Audit.start(Cpu_T::TS_UNB_BIT_DURATION_Q16);
+#endif
+
+		// Give the system the time of four bits to initialize everything (approx. 10ms), the first
+		// burst starts two bits later
+		Cpu.addTimerDelay(4 + 2 - PowerPolicy_T::WAKE_SYMBOLS);
+		txState = TX_STATE_LOAD;
+		txCpuLowPower = false;
+		Cpu.startTimer();
+
+		if (!burstValid) {
+			finishTransmit();
+		}
+	}
+
+	/**
+	 * @brief Initializes the SPI interface unless it is still initialized in the retained state
+	 */
+	void beginSpi(void) {
+		if (!spiActive) {
+			Cpu.spiInit();
+			spiActive = true;
+		}
+	}
+
+	/**
+	 * @brief Deinitializes the SPI interface or stores the register checksum in the retained state
+	 */
+	void endSpi(void) {
+		if (retainState) {
+			regChecksum = readRegisterChecksum();
+			regValid |= RFM69_SHADOW_CHECKSUM;
+			return;
+		}
+		Cpu.spiDeinit();
+		spiActive = false;
+	}
+
+	/**
+	 * @brief Reads the registers of both checksum windows and returns their Fletcher-16 checksum
 	 *
-	 * This method sets the frequency register to the value frequency.
 	 * Caution: This method assumes that SPI is initialized!
+	 */
+	uint16_t readRegisterChecksum(void) {
+		uint8_t data[RFM69_CHECKSUM_LEN_A + 1];
+		uint8_t sum1 = 0;
+		uint8_t sum2 = 0;
+
+		data[0] = RFM69_CHECKSUM_ADDR_A;
+		Cpu.spiSendReceive(data, RFM69_CHECKSUM_LEN_A + 1);
+		addChecksum(&data[1], RFM69_CHECKSUM_LEN_A, sum1, sum2);
+
+		data[0] = RFM69_CHECKSUM_ADDR_B;
+		Cpu.spiSendReceive(data, RFM69_CHECKSUM_LEN_B + 1);
+		addChecksum(&data[1], RFM69_CHECKSUM_LEN_B, sum1, sum2);
+
+		return ((uint16_t)sum2 << 8) | sum1;
+	}
+
+	/**
+	 * @brief Adds bytes to a Fletcher-16 checksum
+	 */
+	static void addChecksum(const uint8_t* const data, const uint8_t numBytes, uint8_t& sum1, uint8_t& sum2) {
+		for (uint8_t i = 0; i < numBytes; ++i) {
+			sum1 = (uint8_t)(((uint16_t)sum1 + data[i]) % 255);
+			sum2 = (uint8_t)(((uint16_t)sum2 + sum1) % 255);
+		}
+	}
+
+	/**
+	 * @brief Brings the transmitter into sleep mode and stops the timer
 	 *
+	 * The timer callback of an interrupt driven transmission is removed as well.
 	 */
-	void setFrequencyReg(const uint32_t frequency) {
-		/*
-		 * Union to simplify byte access.
-		 */
-		union splituint32 {
-			uint8_t bytes[4];
-			uint32_t single;
-		};
-		union splituint32 regVal;
-		regVal.single = frequency;
-		uint8_t data[4] = {
-				RFM69_WRITE_FRF, regVal.bytes[2],
-				regVal.bytes[1], regVal.bytes[0]};
-		Cpu.spiSend(data, 4);
+	void finishTransmit(void) {
+		setMode(RFM69_MODE_SLEEP);
+		Cpu.stopTimer();
+		endSpi();
+		txState = TX_STATE_IDLE;
+
+		if (txInterruptDriven) {
+			Cpu.setTimerCallback(0, 0);
+			txInterruptDriven = false;
+		}
+	}
+
+	/**
+	 * @brief Sets the absolute timer compare value of the next event of a precalculated schedule
+	 *
+	 * The compare value is set first and checked afterwards, so that a timer passing it in
+	 * between is detected as well.
+	 *
+	 * @param	tick	Timer value of the next event
+	 *
+	 * @return	False if the timer has already reached the event, i.e. the compare match would occur one timer period late
+	 */
+	bool setScheduledCompare(const uint16_t tick) {
+		Cpu.setTimerCompare(tick);
+		return (int16_t)(tick - Cpu.getTimerCount()) > 0;
+	}
+
+	/**
+	 * @brief Convert a number of symbols into timer ticks
+	 *
+	 * @param	symbols		Number of symbols
+	 *
+	 * @return	Rounded number of timer ticks
+	 */
+	uint16_t symbolsToTicks(const uint16_t symbols) const {
+		return (uint16_t)(((uint32_t)symbols * Cpu_T::TS_UNB_BIT_DURATION_Q16 + 0x8000u) >> 16);
+	}
+
+	/**
+	 * @brief Convert a number of timer ticks into symbols
+	 *
+	 * @param	ticks		Number of timer ticks
+	 *
+	 * @return	Number of symbols, rounded to the nearest integer like the start ticks of a schedule
+	 */
+	int16_t ticksToSymbols(const uint16_t ticks) const {
+		return (int16_t)((((uint32_t)ticks << 16) + Cpu_T::TS_UNB_BIT_DURATION_Q16 / 2) / Cpu_T::TS_UNB_BIT_DURATION_Q16);
+	}
+
+	/**
+	 * @brief Prepares the SPI data of the radio burst txBurst
+	 *
+	 * This method copies the burst data followed by one dummy byte and the frequency register value
+	 * into txFifo and txFrf, so that loadBurst() only has to transfer them. It is called in the gap
+	 * before the burst, i.e. the load does not depend on the burst content. If the dummy byte is
+	 * actually transmitted, the TX switches itself into sleep mode because we did not set the sleep command.
+	 *
+	 * @param	freqReg		Frequency register value of the burst, MSB first
+	 */
+	void prepareBurst(const uint8_t* const freqReg) {
+		const uint8_t* burstData = txBurst.getBurst();
+		const uint8_t numBytes = txBurst.getBurstLengthBytes();
+		for (uint8_t byteIdx = 0; byteIdx < numBytes; ++byteIdx) {
+			txFifo[byteIdx] = burstData[byteIdx];
+		}
+		txFifo[numBytes] = 0;
+		txFifoLength = numBytes + 1;
+
+		for (uint8_t i = 0; i < 3; ++i) {
+			txFrf[i] = freqReg[i];
+		}
+	}
+
+	/**
+	 * @brief Prepares the SPI data of the radio burst txBurst at the frequency f0 plus its carrier offset
+	 */
+	void prepareBurst(void) {
+		const uint32_t frequency = txFrequency + (uint32_t)txBurst.getCarrierOffset();
+		const uint8_t freqReg[3] = {(uint8_t)(frequency >> 16), (uint8_t)(frequency >> 8), (uint8_t)frequency};
+		prepareBurst(freqReg);
+	}
+
+	/**
+	 * @brief Loads the prepared radio burst and enters FS mode
+	 *
+	 * The frequency register and the FIFO are written using one SPI transaction each.
+	 * This method is called at the wake up PowerPolicy_T::WAKE_SYMBOLS before the burst.
+	 * Caution: This method assumes that SPI is initialized!
+	 */
+	void loadBurst(void) {
+#ifdef TSUNB_TIMING_AUDIT
+		Audit.recordWake(Cpu.getTimerCount());
+#endif
+		writeFrequencyReg(txFrf);
+		Cpu.spiSendBurst(RFM69_WRITE_FIFO, txFifo, txFifoLength);
+		setMode(RFM69_MODE_FS);
+	}
+
+	/**
+	 * @brief Starts the loaded radio burst by entering TX mode
+	 *
+	 * Caution: This method assumes that SPI is initialized!
+	 */
+	void startBurst(void) {
+		setMode(RFM69_MODE_TX);
+#ifdef TSUNB_TIMING_AUDIT
+		Audit.recordTx(Cpu.getTimerCount());
+#endif
+	}
+
+	/**
+	 * @brief Ends the radio burst by entering the power state of the gap
+	 *
+	 * Caution: This method assumes that SPI is initialized!
+	 *
+	 * @param	gap		Time until the wake up before the next burst in symbols
+	 */
+	void endBurst(const int16_t gap) {
+		setMode(PowerPolicy_T::useStandby(gap) ? RFM69_MODE_STDBY : RFM69_MODE_SLEEP);
+	}
+
+	/**
+	 * @brief Write frequency register
+	 *
+	 * This method writes the changed bytes of the frequency register using a single
+	 * auto-increment SPI transaction. A new frequency is only applied by the RFM69HW after
+	 * 'RegFrfLsb' has been written. Hence, all bytes from the first changed byte up to the
+	 * LSB are written. Nothing is written if the frequency has not changed.
+	 * Caution: This method assumes that SPI is initialized!
+	 *
+	 * @param	freqReg		Frequency register value, MSB first
+	 */
+	void writeFrequencyReg(const uint8_t* const freqReg) {
+		uint8_t first = 0;
+		if (regValid & RFM69_SHADOW_FRF) {
+			while (first < 3 && freqReg[first] == regFrf[first])
+				++first;
+			if (first == 3)
+				return;
+		}
+
+		for (uint8_t i = first; i < 3; ++i) {
+			regFrf[i] = freqReg[i];
+		}
+		regValid |= RFM69_SHADOW_FRF;
+		Cpu.spiSendBurst(RFM69_WRITE_FRF + first, &regFrf[first], 3 - first);
 	}
 	
 	/**
@@ -382,15 +984,13 @@ private:
 			// If less than 13dBm use PA1 only, otherwise use PA1 and PA2
 			if (power <= 13) {
 				uint8_t regPower = power + 18;
-				uint8_t data[2] = {RFM69_WRITE_PA_LEVEL,(uint8_t) (RFM69_PA1_ON | regPower)};
-				Cpu.spiSend(data, 2);
+				writePaLevel((uint8_t) (RFM69_PA1_ON | regPower));
 			}
 			else {
 				// Use PA1 and PA2
 				uint8_t regPower = power + 14;
 
-				uint8_t data[2] = {RFM69_WRITE_PA_LEVEL, (uint8_t) (RFM69_PA1_ON | RFM69_PA2_ON | regPower)};
-				Cpu.spiSend(data, 2);
+				writePaLevel((uint8_t) (RFM69_PA1_ON | RFM69_PA2_ON | regPower));
 			}
 			return power;
 		}
@@ -405,8 +1005,7 @@ private:
 
 			uint8_t regPower = power + 18;
 
-			uint8_t data[2] = {RFM69_WRITE_PA_LEVEL, (uint8_t) (RFM69_PA0_ON + regPower)};
-			Cpu.spiSend(data, 2);
+			writePaLevel((uint8_t) (RFM69_PA0_ON + regPower));
 
 			return power;
 		}
@@ -421,12 +1020,88 @@ private:
 	 * @param	mode	RFM69HW mode according to datasheet
 	 */
 	void setMode(const uint8_t mode) {
+		if ((regValid & RFM69_SHADOW_MODE) && regOpMode == mode)
+			return;
+
+		regOpMode = mode;
+		regValid |= RFM69_SHADOW_MODE;
 		uint8_t data[2] = {RFM69_WRITE_MODE, mode};
 		Cpu.spiSend(data, 2);
 	}
 
+	/**
+	 * @brief Write the PA level register if it has changed
+	 *
+	 * Caution: This method assumes that SPI is initialized!
+	 *
+	 * @param	paLevel		Register value of 'RegPaLevel'
+	 */
+	void writePaLevel(const uint8_t paLevel) {
+		if ((regValid & RFM69_SHADOW_PA_LEVEL) && regPaLevel == paLevel)
+			return;
+
+		regPaLevel = paLevel;
+		regValid |= RFM69_SHADOW_PA_LEVEL;
+		uint8_t data[2] = {RFM69_WRITE_PA_LEVEL, paLevel};
+		Cpu.spiSend(data, 2);
+	}
+
 	//! Internal register to store the transmit power
 	int8_t txPower;
+
+	//! Shadow of 'RegFrfMsb', 'RegFrfMid' and 'RegFrfLsb'
+	uint8_t regFrf[3];
+
+	//! Shadow of 'RegPaLevel'
+	uint8_t regPaLevel;
+
+	//! Shadow of 'RegOpMode'
+	uint8_t regOpMode;
+
+	//! Flags RFM69_SHADOW_* of the valid shadow registers and of the valid register checksum
+	uint8_t regValid;
+
+	//! Register checksum after the last access in the retained state
+	uint16_t regChecksum;
+
+	//! True if the SPI interface and the register contents are retained between the accesses
+	bool retainState;
+
+	//! True if the SPI interface is initialized
+	bool spiActive;
+
+	//! Current state of the burst sequencing
+	volatile uint8_t txState;
+
+	//! True if the burst sequencing is performed by the timer callback
+	volatile bool txInterruptDriven;
+
+	//! True if the transmission shall end after the current burst
+	volatile bool txCancel;
+
+	//! True if the next timer event is not time critical and the CPU may use the low power wait
+	bool txCpuLowPower;
+
+	//! Radio burst which is currently transmitted
+	RadioBurst_T txBurst;
+
+	//! Prepared FIFO data of txBurst including the trailing dummy byte
+	uint8_t txFifo[RadioBurst_T::BURST_LENGTH_BYTES + 1];
+
+	//! Number of bytes in txFifo
+	uint8_t txFifoLength;
+
+	//! Prepared 'RegFrf' value of txBurst, MSB first
+	uint8_t txFrf[3];
+
+	//! Frequency f0 of the current transmission
+	uint32_t txFrequency;
+
+	//! Source of the radio bursts of the current transmission
+	void* txSource;
+
+	//! Method to request the next radio burst from txSource
+	bool (*txNextBurst)(void* const, RadioBurst_T* const);
 };
 
 };	// namespace Trx
@@ -0,0 +1,260 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+/**
+ * @brief	Timing audit of the burst transmission
+ *
+ * @file	TimingAudit.h
+ *
+ */
+
+
+#ifndef TIMING_AUDIT_H_
+#define TIMING_AUDIT_H_
+
+#include <stdint.h>
+
+namespace TsUnbLib {
+namespace Trx {
+
+
+/**
+ * @brief Timer values of a single radio burst in timer counts
+ */
+struct TimingAuditEntry {
+	//! Timer value at the wake up before the burst, i.e. when waitTimer() has returned
+	uint16_t wakeTick;
+
+	//! Timer value after the FIFO has been loaded and the FS mode has been set
+	uint16_t loadedTick;
+
+	//! Timer compare value of the switch into TX mode
+	uint16_t txCompare;
+
+	//! Timer value after the switch into TX mode
+	uint16_t txTick;
+};
+
+
+/**
+ * @brief Timing audit of the burst transmission
+ *
+ * This class records the timer values of the radio bursts of a telegram in a ring buffer
+ * with the last SIZE bursts and calculates statistics of the complete telegram:
+ * - slack: time between the completion of the FIFO load and the deadline of the TX switch,
+ *   i.e. a negative value means a missed deadline
+ * - jitter: delay of the TX switch after its deadline
+ * - drift: deviation of the TX switch from the ideal schedule given by the T_RB values or
+ *   the precalculated schedule, relative to the first radio burst
+ *
+ * All values are given in timer counts, e.g. 16us for ArduinoTsUnb. The audit is enabled by
+ * defining TSUNB_TIMING_AUDIT as the size of the ring buffer, otherwise Rfm69hw contains
+ * no audit code at all. The Cpu_T has to offer the methods getTimerCount() and getTimerCompare().
+ *
+ * @tparam	SIZE	Number of radio bursts in the ring buffer
+ */
+template <uint16_t SIZE>
+class TimingAudit {
+public:
+	TimingAudit() {
+		start(0);
+	}
+
+	/**
+	 * @brief Resets the audit at the start of a telegram
+	 *
+	 * @param	ticksPerSymbolQ16_	Duration of a symbol in timer counts as Q16.16 fixed point value
+	 */
+	void start(const uint32_t ticksPerSymbolQ16_) {
+		ticksPerSymbolQ16 = ticksPerSymbolQ16_;
+		numBursts = 0;
+		minSlack = INT16_MAX;
+		maxJitter = 0;
+		drift = 0;
+		maxDrift = 0;
+		idealSymbols = 0;
+		idealExtraTicks = 0;
+		firstTxTick = 0;
+	}
+
+	/**
+	 * @brief Records the wake up before a radio burst
+	 */
+	void recordWake(const uint16_t tick) {
+		Entries[numBursts % SIZE].wakeTick = tick;
+	}
+
+	/**
+	 * @brief Records the completion of the FIFO load and the compare value of the TX switch
+	 */
+	void recordLoaded(const uint16_t tick, const uint16_t txCompare) {
+		TimingAuditEntry& Entry = Entries[numBursts % SIZE];
+		Entry.loadedTick = tick;
+		Entry.txCompare = txCompare;
+
+		const int16_t slack = (int16_t)(txCompare - tick);
+		if (slack < minSlack)
+			minSlack = slack;
+	}
+
+	/**
+	 * @brief Records the switch into TX mode
+	 */
+	void recordTx(const uint16_t tick) {
+		TimingAuditEntry& Entry = Entries[numBursts % SIZE];
+		Entry.txTick = tick;
+
+		const uint16_t jitter = tick - Entry.txCompare;
+		if (jitter < 0x8000u && jitter > maxJitter)
+			maxJitter = jitter;
+
+		if (numBursts == 0)
+			firstTxTick = tick;
+		const uint16_t idealTicks = (uint16_t)(((uint64_t)idealSymbols * ticksPerSymbolQ16 + 0x8000u) >> 16) + idealExtraTicks;
+		drift = (int16_t)(tick - firstTxTick - idealTicks);
+		const int16_t absDrift = drift < 0 ? -drift : drift;
+		if (absDrift > maxDrift)
+			maxDrift = absDrift;
+
+		++numBursts;
+	}
+
+	/**
+	 * @brief Advances the ideal schedule by the time T_RB to the next radio burst
+	 *
+	 * @param	T_RB	Time to the next radio burst in symbols
+	 */
+	void addSymbols(const uint16_t T_RB) {
+		if (numBursts > 0)
+			idealSymbols += T_RB;
+	}
+
+	/**
+	 * @brief Advances the ideal schedule by the time to the next radio burst in timer counts
+	 *
+	 * This method is used for precalculated schedules, e.g. with the bursts of several telegrams.
+	 *
+	 * @param	ticks	Time to the next radio burst in timer counts
+	 */
+	void addTicks(const uint16_t ticks) {
+		if (numBursts > 0)
+			idealExtraTicks += ticks;
+	}
+
+	/**
+	 * @brief Returns the entry of a radio burst of the current telegram
+	 *
+	 * Only the last SIZE radio bursts are available.
+	 *
+	 * @param	burstIdx	Index of the radio burst within the telegram
+	 */
+	const TimingAuditEntry& getEntry(const uint16_t burstIdx) const {
+		return Entries[burstIdx % SIZE];
+	}
+
+	//! Number of radio bursts of the telegram
+	uint16_t numBursts;
+
+	//! Minimum slack of all radio bursts
+	int16_t minSlack;
+
+	//! Maximum jitter of all radio bursts
+	uint16_t maxJitter;
+
+	//! Drift of the last radio burst
+	int16_t drift;
+
+	//! Maximum absolute drift of all radio bursts
+	int16_t maxDrift;
+
+private:
+	//! Ring buffer with the last SIZE radio bursts
+	TimingAuditEntry Entries[SIZE];
+
+	//! Duration of a symbol in timer counts as Q16.16 fixed point value
+	uint32_t ticksPerSymbolQ16;
+
+	//! Start time of the next radio burst in symbols relative to the first radio burst
+	uint32_t idealSymbols;
+
+	//! Start time of the next radio burst in timer counts added by addTicks(), modulo 2^16
+	uint16_t idealExtraTicks;
+
+	//! Timer value of the TX switch of the first radio burst
+	uint16_t firstTxTick;
+};
+
+};	// namespace Trx
+};	// namespace TsUnbLib
+
+#endif	/* TIMING_AUDIT_H_ */
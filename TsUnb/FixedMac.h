@@ -113,6 +113,10 @@ namespace TsUnb {
  * @brief Block size of the AES encryption in bytes
  */
 #define BLOCK_SIZE_AES      16
+/**
+ * @brief Maximum MAC overhead in bytes, i.e. with the MPF field and the long address
+ */
+#define FIXEDMAC_MAX_OVERHEAD	17
 
 //! ENUM for the different address modes
 enum TsUnbAddressMode {
@@ -251,6 +255,21 @@ public:
 		return ret;
 	}
 
+	/**
+	 * @brief	Get the maximum MPDU length for MAC_PayloadLength at compile time
+	 *
+	 * In contrast to MPDU_Length(), the result does not depend on the address mode and
+	 * assumes that the MPF field is present. It can be used to size the buffers.
+	 *
+	 * @param	MAC_PayloadLength	Payload length of the MAC
+	 *
+	 * @return	Maximum length of the MPDU
+	 *
+	 */
+	static constexpr uint16_t maxMPDU_Length(const uint16_t MAC_PayloadLength) {
+		return MAC_PayloadLength + FIXEDMAC_MAX_OVERHEAD;
+	}
+
 
 	/**
 	 * @brief	Set the 16 byte network key.
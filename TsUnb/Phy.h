@@ -175,6 +175,23 @@ namespace TsUnb {
  */
 #define TSUNBPHY_TSMA_PATTERN_CYCLE  15
 
+//! Number of telegrams that are encoded in parallel by the bit-sliced encoder
+#define TSUNBPHY_NUM_LANES			64
+
+
+/**
+ * @brief Entry of a precalculated transmission schedule
+ *
+ * Each entry contains the absolute start time and the absolute frequency of a radio burst.
+ */
+struct TxScheduleEntry {
+	//! Start time of the radio burst in timer ticks relative to the first radio burst, modulo 2^16
+	uint16_t startTick;
+
+	//! Frequency of the radio burst as transmitter register value, MSB first
+	uint8_t freqReg[3];
+};
+
 
 //! ENUM for the different uplink pattern groups
 enum TsUnbUPGMode {
@@ -184,6 +201,217 @@ enum TsUnbUPGMode {
 };
 
 
+//! Mask of the carrier C_RB in a packed TSMA pattern entry
+#define TSUNBPHY_TSMA_CARRIER_MASK		0x1F
+
+//! Shift of the time T_RB in a packed TSMA pattern entry
+#define TSUNBPHY_TSMA_TIME_SHIFT		5
+
+/**
+ * @brief Packs the carrier C_RB and the time T_RB of a core burst into a single TSMA pattern entry
+ *
+ * T_RB is the time to the following burst, it is 0 for the last core burst.
+ */
+#define TSUNBPHY_TSMA_ENTRY(C_RB, T_RB)	((uint16_t)(((T_RB) << TSUNBPHY_TSMA_TIME_SHIFT) | (C_RB)))
+
+
+/**
+ * @brief TSMA uplink patterns of the core frame
+ *
+ * This class is specialized for each uplink pattern group, so that only the tables of
+ * the selected group are instantiated. Each pattern is stored as one array of 24 packed
+ * (C_RB, T_RB) entries, see TSUNBPHY_TSMA_ENTRY, which is walked burst by burst.
+ */
+template <TsUnbUPGMode UPG>
+class TsmaPatternTable;
+
+
+/**
+ * @brief TSMA uplink patterns of the UPG1 according to 6.4.7.1.6.1
+ */
+template <>
+class TsmaPatternTable<TsUnb_UPG1> {
+public:
+	//! Extension frame spacing constant
+	static const uint16_t TIME_SPACING = TSUNBPHY_TIME_SPACING_UPG1;
+
+	/**
+	 * @brief Returns the packed TSMA pattern
+	 *
+	 * @param	TSMAPattern		Used TSMA pattern, caution: index starts with 0 (standard starts with 1)
+	 *
+	 * @return	Pointer to the 24 packed entries of the pattern
+	 */
+	static const uint16_t* getPattern(const uint8_t TSMAPattern) {
+		static const
+#ifdef __AVR_ARCH__
+		PROGMEM
+#endif
+		uint16_t TSMA_PATTERN[TSUNBPHY_UNB_NUM_P][TSUNBPHY_NUM_CORE_BURSTS] = {
+			{TSUNBPHY_TSMA_ENTRY( 5, 330), TSUNBPHY_TSMA_ENTRY(21, 387), TSUNBPHY_TSMA_ENTRY(13, 388), TSUNBPHY_TSMA_ENTRY( 6, 330),
+				TSUNBPHY_TSMA_ENTRY(22, 387), TSUNBPHY_TSMA_ENTRY(14, 354), TSUNBPHY_TSMA_ENTRY( 1, 330), TSUNBPHY_TSMA_ENTRY(17, 387),
+				TSUNBPHY_TSMA_ENTRY( 9, 356), TSUNBPHY_TSMA_ENTRY( 0, 330), TSUNBPHY_TSMA_ENTRY(16, 387), TSUNBPHY_TSMA_ENTRY( 8, 432),
+				TSUNBPHY_TSMA_ENTRY( 7, 330), TSUNBPHY_TSMA_ENTRY(23, 387), TSUNBPHY_TSMA_ENTRY(15, 352), TSUNBPHY_TSMA_ENTRY( 4, 330),
+				TSUNBPHY_TSMA_ENTRY(20, 387), TSUNBPHY_TSMA_ENTRY(12, 467), TSUNBPHY_TSMA_ENTRY( 3, 330), TSUNBPHY_TSMA_ENTRY(19, 387),
+				TSUNBPHY_TSMA_ENTRY(11, 620), TSUNBPHY_TSMA_ENTRY( 2, 330), TSUNBPHY_TSMA_ENTRY(18, 387), TSUNBPHY_TSMA_ENTRY(10,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 4, 330), TSUNBPHY_TSMA_ENTRY(20, 387), TSUNBPHY_TSMA_ENTRY(12, 435), TSUNBPHY_TSMA_ENTRY( 1, 330),
+				TSUNBPHY_TSMA_ENTRY(17, 387), TSUNBPHY_TSMA_ENTRY( 9, 409), TSUNBPHY_TSMA_ENTRY( 0, 330), TSUNBPHY_TSMA_ENTRY(16, 387),
+				TSUNBPHY_TSMA_ENTRY( 8, 398), TSUNBPHY_TSMA_ENTRY( 6, 330), TSUNBPHY_TSMA_ENTRY(22, 387), TSUNBPHY_TSMA_ENTRY(14, 370),
+				TSUNBPHY_TSMA_ENTRY( 7, 330), TSUNBPHY_TSMA_ENTRY(23, 387), TSUNBPHY_TSMA_ENTRY(15, 361), TSUNBPHY_TSMA_ENTRY( 2, 330),
+				TSUNBPHY_TSMA_ENTRY(18, 387), TSUNBPHY_TSMA_ENTRY(10, 472), TSUNBPHY_TSMA_ENTRY( 5, 330), TSUNBPHY_TSMA_ENTRY(21, 387),
+				TSUNBPHY_TSMA_ENTRY(13, 522), TSUNBPHY_TSMA_ENTRY( 3, 330), TSUNBPHY_TSMA_ENTRY(19, 387), TSUNBPHY_TSMA_ENTRY(11,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 4, 330), TSUNBPHY_TSMA_ENTRY(20, 387), TSUNBPHY_TSMA_ENTRY(12, 356), TSUNBPHY_TSMA_ENTRY( 3, 330),
+				TSUNBPHY_TSMA_ENTRY(19, 387), TSUNBPHY_TSMA_ENTRY(11, 439), TSUNBPHY_TSMA_ENTRY( 6, 330), TSUNBPHY_TSMA_ENTRY(22, 387),
+				TSUNBPHY_TSMA_ENTRY(14, 413), TSUNBPHY_TSMA_ENTRY( 7, 330), TSUNBPHY_TSMA_ENTRY(23, 387), TSUNBPHY_TSMA_ENTRY(15, 352),
+				TSUNBPHY_TSMA_ENTRY( 0, 330), TSUNBPHY_TSMA_ENTRY(16, 387), TSUNBPHY_TSMA_ENTRY( 8, 485), TSUNBPHY_TSMA_ENTRY( 5, 330),
+				TSUNBPHY_TSMA_ENTRY(21, 387), TSUNBPHY_TSMA_ENTRY(13, 397), TSUNBPHY_TSMA_ENTRY( 2, 330), TSUNBPHY_TSMA_ENTRY(18, 387),
+				TSUNBPHY_TSMA_ENTRY(10, 444), TSUNBPHY_TSMA_ENTRY( 1, 330), TSUNBPHY_TSMA_ENTRY(17, 387), TSUNBPHY_TSMA_ENTRY( 9,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 6, 330), TSUNBPHY_TSMA_ENTRY(22, 387), TSUNBPHY_TSMA_ENTRY(14, 352), TSUNBPHY_TSMA_ENTRY( 2, 330),
+				TSUNBPHY_TSMA_ENTRY(18, 387), TSUNBPHY_TSMA_ENTRY(10, 382), TSUNBPHY_TSMA_ENTRY( 7, 330), TSUNBPHY_TSMA_ENTRY(23, 387),
+				TSUNBPHY_TSMA_ENTRY(15, 381), TSUNBPHY_TSMA_ENTRY( 0, 330), TSUNBPHY_TSMA_ENTRY(16, 387), TSUNBPHY_TSMA_ENTRY( 8, 365),
+				TSUNBPHY_TSMA_ENTRY( 1, 330), TSUNBPHY_TSMA_ENTRY(17, 387), TSUNBPHY_TSMA_ENTRY( 9, 595), TSUNBPHY_TSMA_ENTRY( 4, 330),
+				TSUNBPHY_TSMA_ENTRY(20, 387), TSUNBPHY_TSMA_ENTRY(12, 604), TSUNBPHY_TSMA_ENTRY( 5, 330), TSUNBPHY_TSMA_ENTRY(21, 387),
+				TSUNBPHY_TSMA_ENTRY(13, 352), TSUNBPHY_TSMA_ENTRY( 3, 330), TSUNBPHY_TSMA_ENTRY(19, 387), TSUNBPHY_TSMA_ENTRY(11,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 7, 330), TSUNBPHY_TSMA_ENTRY(23, 387), TSUNBPHY_TSMA_ENTRY(15, 380), TSUNBPHY_TSMA_ENTRY( 4, 330),
+				TSUNBPHY_TSMA_ENTRY(20, 387), TSUNBPHY_TSMA_ENTRY(12, 634), TSUNBPHY_TSMA_ENTRY( 3, 330), TSUNBPHY_TSMA_ENTRY(19, 387),
+				TSUNBPHY_TSMA_ENTRY(11, 360), TSUNBPHY_TSMA_ENTRY( 2, 330), TSUNBPHY_TSMA_ENTRY(18, 387), TSUNBPHY_TSMA_ENTRY(10, 393),
+				TSUNBPHY_TSMA_ENTRY( 6, 330), TSUNBPHY_TSMA_ENTRY(22, 387), TSUNBPHY_TSMA_ENTRY(14, 352), TSUNBPHY_TSMA_ENTRY( 0, 330),
+				TSUNBPHY_TSMA_ENTRY(16, 387), TSUNBPHY_TSMA_ENTRY( 8, 373), TSUNBPHY_TSMA_ENTRY( 1, 330), TSUNBPHY_TSMA_ENTRY(17, 387),
+				TSUNBPHY_TSMA_ENTRY( 9, 490), TSUNBPHY_TSMA_ENTRY( 5, 330), TSUNBPHY_TSMA_ENTRY(21, 387), TSUNBPHY_TSMA_ENTRY(13,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 3, 330), TSUNBPHY_TSMA_ENTRY(19, 387), TSUNBPHY_TSMA_ENTRY(11, 364), TSUNBPHY_TSMA_ENTRY( 6, 330),
+				TSUNBPHY_TSMA_ENTRY(22, 387), TSUNBPHY_TSMA_ENTRY(14, 375), TSUNBPHY_TSMA_ENTRY( 2, 330), TSUNBPHY_TSMA_ENTRY(18, 387),
+				TSUNBPHY_TSMA_ENTRY(10, 474), TSUNBPHY_TSMA_ENTRY( 0, 330), TSUNBPHY_TSMA_ENTRY(16, 387), TSUNBPHY_TSMA_ENTRY( 8, 355),
+				TSUNBPHY_TSMA_ENTRY( 7, 330), TSUNBPHY_TSMA_ENTRY(23, 387), TSUNBPHY_TSMA_ENTRY(15, 478), TSUNBPHY_TSMA_ENTRY( 1, 330),
+				TSUNBPHY_TSMA_ENTRY(17, 387), TSUNBPHY_TSMA_ENTRY( 9, 464), TSUNBPHY_TSMA_ENTRY( 4, 330), TSUNBPHY_TSMA_ENTRY(20, 387),
+				TSUNBPHY_TSMA_ENTRY(12, 513), TSUNBPHY_TSMA_ENTRY( 5, 330), TSUNBPHY_TSMA_ENTRY(21, 387), TSUNBPHY_TSMA_ENTRY(13,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 3, 330), TSUNBPHY_TSMA_ENTRY(19, 387), TSUNBPHY_TSMA_ENTRY(11, 472), TSUNBPHY_TSMA_ENTRY( 1, 330),
+				TSUNBPHY_TSMA_ENTRY(17, 387), TSUNBPHY_TSMA_ENTRY( 9, 546), TSUNBPHY_TSMA_ENTRY( 5, 330), TSUNBPHY_TSMA_ENTRY(21, 387),
+				TSUNBPHY_TSMA_ENTRY(13, 501), TSUNBPHY_TSMA_ENTRY( 7, 330), TSUNBPHY_TSMA_ENTRY(23, 387), TSUNBPHY_TSMA_ENTRY(15, 356),
+				TSUNBPHY_TSMA_ENTRY( 0, 330), TSUNBPHY_TSMA_ENTRY(16, 387), TSUNBPHY_TSMA_ENTRY( 8, 359), TSUNBPHY_TSMA_ENTRY( 2, 330),
+				TSUNBPHY_TSMA_ENTRY(18, 387), TSUNBPHY_TSMA_ENTRY(10, 359), TSUNBPHY_TSMA_ENTRY( 6, 330), TSUNBPHY_TSMA_ENTRY(22, 387),
+				TSUNBPHY_TSMA_ENTRY(14, 364), TSUNBPHY_TSMA_ENTRY( 4, 330), TSUNBPHY_TSMA_ENTRY(20, 387), TSUNBPHY_TSMA_ENTRY(12,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 0, 330), TSUNBPHY_TSMA_ENTRY(16, 387), TSUNBPHY_TSMA_ENTRY( 8, 391), TSUNBPHY_TSMA_ENTRY( 6, 330),
+				TSUNBPHY_TSMA_ENTRY(22, 387), TSUNBPHY_TSMA_ENTRY(14, 468), TSUNBPHY_TSMA_ENTRY( 3, 330), TSUNBPHY_TSMA_ENTRY(19, 387),
+				TSUNBPHY_TSMA_ENTRY(11, 512), TSUNBPHY_TSMA_ENTRY( 2, 330), TSUNBPHY_TSMA_ENTRY(18, 387), TSUNBPHY_TSMA_ENTRY(10, 543),
+				TSUNBPHY_TSMA_ENTRY( 4, 330), TSUNBPHY_TSMA_ENTRY(20, 387), TSUNBPHY_TSMA_ENTRY(12, 354), TSUNBPHY_TSMA_ENTRY( 7, 330),
+				TSUNBPHY_TSMA_ENTRY(23, 387), TSUNBPHY_TSMA_ENTRY(15, 391), TSUNBPHY_TSMA_ENTRY( 5, 330), TSUNBPHY_TSMA_ENTRY(21, 387),
+				TSUNBPHY_TSMA_ENTRY(13, 368), TSUNBPHY_TSMA_ENTRY( 1, 330), TSUNBPHY_TSMA_ENTRY(17, 387), TSUNBPHY_TSMA_ENTRY( 9,   0)}};
+
+		return TSMA_PATTERN[TSMAPattern];
+	}
+};
+
+
+/**
+ * @brief TSMA uplink patterns of the UPG2 according to 6.4.7.1.6.1
+ */
+template <>
+class TsmaPatternTable<TsUnb_UPG2> {
+public:
+	//! Extension frame spacing constant
+	static const uint16_t TIME_SPACING = TSUNBPHY_TIME_SPACING_UPG2;
+
+	/**
+	 * @brief Returns the packed TSMA pattern
+	 *
+	 * @param	TSMAPattern		Used TSMA pattern, caution: index starts with 0 (standard starts with 1)
+	 *
+	 * @return	Pointer to the 24 packed entries of the pattern
+	 */
+	static const uint16_t* getPattern(const uint8_t TSMAPattern) {
+		static const
+#ifdef __AVR_ARCH__
+		PROGMEM
+#endif
+		uint16_t TSMA_PATTERN[TSUNBPHY_UNB_NUM_P][TSUNBPHY_NUM_CORE_BURSTS] = {
+			{TSUNBPHY_TSMA_ENTRY( 4, 373), TSUNBPHY_TSMA_ENTRY(20, 319), TSUNBPHY_TSMA_ENTRY(12, 545), TSUNBPHY_TSMA_ENTRY( 0, 373),
+				TSUNBPHY_TSMA_ENTRY(16, 319), TSUNBPHY_TSMA_ENTRY( 8, 443), TSUNBPHY_TSMA_ENTRY( 3, 373), TSUNBPHY_TSMA_ENTRY(19, 319),
+				TSUNBPHY_TSMA_ENTRY(11, 349), TSUNBPHY_TSMA_ENTRY( 5, 373), TSUNBPHY_TSMA_ENTRY(21, 319), TSUNBPHY_TSMA_ENTRY(13, 454),
+				TSUNBPHY_TSMA_ENTRY( 1, 373), TSUNBPHY_TSMA_ENTRY(17, 319), TSUNBPHY_TSMA_ENTRY( 9, 578), TSUNBPHY_TSMA_ENTRY( 7, 373),
+				TSUNBPHY_TSMA_ENTRY(23, 319), TSUNBPHY_TSMA_ENTRY(15, 436), TSUNBPHY_TSMA_ENTRY( 2, 373), TSUNBPHY_TSMA_ENTRY(18, 319),
+				TSUNBPHY_TSMA_ENTRY(10, 398), TSUNBPHY_TSMA_ENTRY( 6, 373), TSUNBPHY_TSMA_ENTRY(22, 319), TSUNBPHY_TSMA_ENTRY(14,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 3, 373), TSUNBPHY_TSMA_ENTRY(19, 319), TSUNBPHY_TSMA_ENTRY(11, 371), TSUNBPHY_TSMA_ENTRY( 7, 373),
+				TSUNBPHY_TSMA_ENTRY(23, 319), TSUNBPHY_TSMA_ENTRY(15, 410), TSUNBPHY_TSMA_ENTRY( 2, 373), TSUNBPHY_TSMA_ENTRY(18, 319),
+				TSUNBPHY_TSMA_ENTRY(10, 363), TSUNBPHY_TSMA_ENTRY( 5, 373), TSUNBPHY_TSMA_ENTRY(21, 319), TSUNBPHY_TSMA_ENTRY(13, 354),
+				TSUNBPHY_TSMA_ENTRY( 4, 373), TSUNBPHY_TSMA_ENTRY(20, 319), TSUNBPHY_TSMA_ENTRY(12, 379), TSUNBPHY_TSMA_ENTRY( 0, 373),
+				TSUNBPHY_TSMA_ENTRY(16, 319), TSUNBPHY_TSMA_ENTRY( 8, 657), TSUNBPHY_TSMA_ENTRY( 1, 373), TSUNBPHY_TSMA_ENTRY(17, 319),
+				TSUNBPHY_TSMA_ENTRY( 9, 376), TSUNBPHY_TSMA_ENTRY( 6, 373), TSUNBPHY_TSMA_ENTRY(22, 319), TSUNBPHY_TSMA_ENTRY(14,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 6, 373), TSUNBPHY_TSMA_ENTRY(22, 319), TSUNBPHY_TSMA_ENTRY(14, 414), TSUNBPHY_TSMA_ENTRY( 0, 373),
+				TSUNBPHY_TSMA_ENTRY(16, 319), TSUNBPHY_TSMA_ENTRY( 8, 502), TSUNBPHY_TSMA_ENTRY( 1, 373), TSUNBPHY_TSMA_ENTRY(17, 319),
+				TSUNBPHY_TSMA_ENTRY( 9, 433), TSUNBPHY_TSMA_ENTRY( 4, 373), TSUNBPHY_TSMA_ENTRY(20, 319), TSUNBPHY_TSMA_ENTRY(12, 540),
+				TSUNBPHY_TSMA_ENTRY( 3, 373), TSUNBPHY_TSMA_ENTRY(19, 319), TSUNBPHY_TSMA_ENTRY(11, 428), TSUNBPHY_TSMA_ENTRY( 5, 373),
+				TSUNBPHY_TSMA_ENTRY(21, 319), TSUNBPHY_TSMA_ENTRY(13, 467), TSUNBPHY_TSMA_ENTRY( 2, 373), TSUNBPHY_TSMA_ENTRY(18, 319),
+				TSUNBPHY_TSMA_ENTRY(10, 409), TSUNBPHY_TSMA_ENTRY( 7, 373), TSUNBPHY_TSMA_ENTRY(23, 319), TSUNBPHY_TSMA_ENTRY(15,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 3, 373), TSUNBPHY_TSMA_ENTRY(19, 319), TSUNBPHY_TSMA_ENTRY(11, 396), TSUNBPHY_TSMA_ENTRY( 1, 373),
+				TSUNBPHY_TSMA_ENTRY(17, 319), TSUNBPHY_TSMA_ENTRY( 9, 516), TSUNBPHY_TSMA_ENTRY( 4, 373), TSUNBPHY_TSMA_ENTRY(20, 319),
+				TSUNBPHY_TSMA_ENTRY(12, 631), TSUNBPHY_TSMA_ENTRY( 5, 373), TSUNBPHY_TSMA_ENTRY(21, 319), TSUNBPHY_TSMA_ENTRY(13, 471),
+				TSUNBPHY_TSMA_ENTRY( 2, 373), TSUNBPHY_TSMA_ENTRY(18, 319), TSUNBPHY_TSMA_ENTRY(10, 457), TSUNBPHY_TSMA_ENTRY( 7, 373),
+				TSUNBPHY_TSMA_ENTRY(23, 319), TSUNBPHY_TSMA_ENTRY(15, 416), TSUNBPHY_TSMA_ENTRY( 6, 373), TSUNBPHY_TSMA_ENTRY(22, 319),
+				TSUNBPHY_TSMA_ENTRY(14, 354), TSUNBPHY_TSMA_ENTRY( 0, 373), TSUNBPHY_TSMA_ENTRY(16, 319), TSUNBPHY_TSMA_ENTRY( 8,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 5, 373), TSUNBPHY_TSMA_ENTRY(21, 319), TSUNBPHY_TSMA_ENTRY(13, 655), TSUNBPHY_TSMA_ENTRY( 2, 373),
+				TSUNBPHY_TSMA_ENTRY(18, 319), TSUNBPHY_TSMA_ENTRY(10, 416), TSUNBPHY_TSMA_ENTRY( 0, 373), TSUNBPHY_TSMA_ENTRY(16, 319),
+				TSUNBPHY_TSMA_ENTRY( 8, 367), TSUNBPHY_TSMA_ENTRY( 6, 373), TSUNBPHY_TSMA_ENTRY(22, 319), TSUNBPHY_TSMA_ENTRY(14, 400),
+				TSUNBPHY_TSMA_ENTRY( 7, 373), TSUNBPHY_TSMA_ENTRY(23, 319), TSUNBPHY_TSMA_ENTRY(15, 415), TSUNBPHY_TSMA_ENTRY( 1, 373),
+				TSUNBPHY_TSMA_ENTRY(17, 319), TSUNBPHY_TSMA_ENTRY( 9, 342), TSUNBPHY_TSMA_ENTRY( 4, 373), TSUNBPHY_TSMA_ENTRY(20, 319),
+				TSUNBPHY_TSMA_ENTRY(12, 560), TSUNBPHY_TSMA_ENTRY( 3, 373), TSUNBPHY_TSMA_ENTRY(19, 319), TSUNBPHY_TSMA_ENTRY(11,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 1, 373), TSUNBPHY_TSMA_ENTRY(17, 319), TSUNBPHY_TSMA_ENTRY( 9, 370), TSUNBPHY_TSMA_ENTRY( 3, 373),
+				TSUNBPHY_TSMA_ENTRY(19, 319), TSUNBPHY_TSMA_ENTRY(11, 451), TSUNBPHY_TSMA_ENTRY( 4, 373), TSUNBPHY_TSMA_ENTRY(20, 319),
+				TSUNBPHY_TSMA_ENTRY(12, 465), TSUNBPHY_TSMA_ENTRY( 6, 373), TSUNBPHY_TSMA_ENTRY(22, 319), TSUNBPHY_TSMA_ENTRY(14, 593),
+				TSUNBPHY_TSMA_ENTRY( 7, 373), TSUNBPHY_TSMA_ENTRY(23, 319), TSUNBPHY_TSMA_ENTRY(15, 545), TSUNBPHY_TSMA_ENTRY( 5, 373),
+				TSUNBPHY_TSMA_ENTRY(21, 319), TSUNBPHY_TSMA_ENTRY(13, 380), TSUNBPHY_TSMA_ENTRY( 2, 373), TSUNBPHY_TSMA_ENTRY(18, 319),
+				TSUNBPHY_TSMA_ENTRY(10, 365), TSUNBPHY_TSMA_ENTRY( 0, 373), TSUNBPHY_TSMA_ENTRY(16, 319), TSUNBPHY_TSMA_ENTRY( 8,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 5, 373), TSUNBPHY_TSMA_ENTRY(21, 319), TSUNBPHY_TSMA_ENTRY(13, 393), TSUNBPHY_TSMA_ENTRY( 1, 373),
+				TSUNBPHY_TSMA_ENTRY(17, 319), TSUNBPHY_TSMA_ENTRY( 9, 374), TSUNBPHY_TSMA_ENTRY( 2, 373), TSUNBPHY_TSMA_ENTRY(18, 319),
+				TSUNBPHY_TSMA_ENTRY(10, 344), TSUNBPHY_TSMA_ENTRY( 4, 373), TSUNBPHY_TSMA_ENTRY(20, 319), TSUNBPHY_TSMA_ENTRY(12, 353),
+				TSUNBPHY_TSMA_ENTRY( 3, 373), TSUNBPHY_TSMA_ENTRY(19, 319), TSUNBPHY_TSMA_ENTRY(11, 620), TSUNBPHY_TSMA_ENTRY( 0, 373),
+				TSUNBPHY_TSMA_ENTRY(16, 319), TSUNBPHY_TSMA_ENTRY( 8, 503), TSUNBPHY_TSMA_ENTRY( 6, 373), TSUNBPHY_TSMA_ENTRY(22, 319),
+				TSUNBPHY_TSMA_ENTRY(14, 546), TSUNBPHY_TSMA_ENTRY( 7, 373), TSUNBPHY_TSMA_ENTRY(23, 319), TSUNBPHY_TSMA_ENTRY(15,   0)},
+			{TSUNBPHY_TSMA_ENTRY( 3, 373), TSUNBPHY_TSMA_ENTRY(19, 319), TSUNBPHY_TSMA_ENTRY(11, 367), TSUNBPHY_TSMA_ENTRY( 6, 373),
+				TSUNBPHY_TSMA_ENTRY(22, 319), TSUNBPHY_TSMA_ENTRY(14, 346), TSUNBPHY_TSMA_ENTRY( 5, 373), TSUNBPHY_TSMA_ENTRY(21, 319),
+				TSUNBPHY_TSMA_ENTRY(13, 584), TSUNBPHY_TSMA_ENTRY( 1, 373), TSUNBPHY_TSMA_ENTRY(17, 319), TSUNBPHY_TSMA_ENTRY( 9, 579),
+				TSUNBPHY_TSMA_ENTRY( 7, 373), TSUNBPHY_TSMA_ENTRY(23, 319), TSUNBPHY_TSMA_ENTRY(15, 519), TSUNBPHY_TSMA_ENTRY( 2, 373),
+				TSUNBPHY_TSMA_ENTRY(18, 319), TSUNBPHY_TSMA_ENTRY(10, 351), TSUNBPHY_TSMA_ENTRY( 0, 373), TSUNBPHY_TSMA_ENTRY(16, 319),
+				TSUNBPHY_TSMA_ENTRY( 8, 486), TSUNBPHY_TSMA_ENTRY( 4, 373), TSUNBPHY_TSMA_ENTRY(20, 319), TSUNBPHY_TSMA_ENTRY(12,   0)}};
+
+		return TSMA_PATTERN[TSMAPattern];
+	}
+};
+
+
+/**
+ * @brief TSMA uplink patterns of the UPG3 according to 6.4.7.1.6.1
+ */
+template <>
+class TsmaPatternTable<TsUnb_UPG3> {
+public:
+	//! Extension frame spacing constant
+	static const uint16_t TIME_SPACING = TSUNBPHY_TIME_SPACING_UPG3;
+
+	/**
+	 * @brief Returns the packed TSMA pattern
+	 *
+	 * The TSMA pattern parameter is ignored, as UPG3 has only a single pattern.
+	 *
+	 * @return	Pointer to the 24 packed entries of the pattern
+	 */
+	static const uint16_t* getPattern(const uint8_t) {
+		static const
+#ifdef __AVR_ARCH__
+		PROGMEM
+#endif
+		uint16_t TSMA_PATTERN[TSUNBPHY_NUM_CORE_BURSTS] =
+				{TSUNBPHY_TSMA_ENTRY( 1,  66), TSUNBPHY_TSMA_ENTRY( 5,  66), TSUNBPHY_TSMA_ENTRY( 4,  66), TSUNBPHY_TSMA_ENTRY( 3,  66),
+				TSUNBPHY_TSMA_ENTRY( 2,  66), TSUNBPHY_TSMA_ENTRY(17,  66), TSUNBPHY_TSMA_ENTRY(21,  66), TSUNBPHY_TSMA_ENTRY(20,  66),
+				TSUNBPHY_TSMA_ENTRY(19,  66), TSUNBPHY_TSMA_ENTRY(18, 123), TSUNBPHY_TSMA_ENTRY( 9,  66), TSUNBPHY_TSMA_ENTRY(13,  66),
+				TSUNBPHY_TSMA_ENTRY(12,  66), TSUNBPHY_TSMA_ENTRY(11,  66), TSUNBPHY_TSMA_ENTRY(10,  60), TSUNBPHY_TSMA_ENTRY( 6,  66),
+				TSUNBPHY_TSMA_ENTRY( 0,  66), TSUNBPHY_TSMA_ENTRY( 7, 198), TSUNBPHY_TSMA_ENTRY(22,  66), TSUNBPHY_TSMA_ENTRY(16,  66),
+				TSUNBPHY_TSMA_ENTRY(23, 255), TSUNBPHY_TSMA_ENTRY(14,  66), TSUNBPHY_TSMA_ENTRY( 8,  66), TSUNBPHY_TSMA_ENTRY(15,   0)};
+
+		return TSMA_PATTERN;
+	}
+};
+
+
 /**
  * @brief Implementation of ETSI TS 103 357 TS-UNB Uplink Physical Layer (PHY)
  *
@@ -205,22 +433,30 @@ enum TsUnbUPGMode {
  * It can take the values 3 (crystal tolerance >= 10ppm) or 11 (crytal tolerance < 10ppm).
  *
  * The template class RadioBurst_T defines a radio burst data structure. The actual implementation has to
- * offer the methods: uint16_t getBurstLength(void), uint8_t* getBurst(void), uint16_t get_channel(void).
+ * offer the methods: uint16_t getBurstLength(void), uint8_t* getBurst(void), uint16_t get_channel(void),
+ * and the constant CARRIER_STEP, which is either 1 or the B_c of the PHY, if only carrier indices are stored.
  *
  */
 template <uint32_t CHAN_A = 14224261, uint32_t CHAN_B = 14222623,
 		uint32_t B_c = 39, uint32_t B_c0 = 39, TsUnbUPGMode TSUNB_UPG = TsUnb_UPG1,
 		uint8_t n_co = 3, class RadioBurst_T = TsUnb::RadioBurst <> >
 class Phy {
+	static_assert(RadioBurst_T::CARRIER_STEP == 1 || RadioBurst_T::CARRIER_STEP == B_c,
+			"The carrier step of the radio burst does not match the carrier spacing B_c of the PHY");
 
 public:
 	//! Type of the radio bursts
 	typedef RadioBurst_T RadioBurst_t;
 
 	/**
-	 * @brief Constructor, which is currently not used
+	 * @brief Constructor
 	 */
 	Phy() {
+		streamPayload = 0;
+		streamNumBursts = 0;
+		streamBurstIdx = 0;
+		streamLfsrSeed = 0;
+		streamTsmaPattern = 0;
 	};
 
 	/**
@@ -254,156 +490,338 @@ public:
 
 		const uint16_t numBursts = numRadioBursts(MPDU_Length);
 
+		/*
+		 * Copy data to local buffer, set fields and whiten the data
+		 */
+		uint8_t PhyPayload[TSUNBPHY_MAX_PSDU_LENGTH + TSUNBPHY_OVERHEAD];
+
+		//! LFSR seed for burst positions in case of extension frame, the LSB is the payload CRC
+		const uint16_t lfsrSeed = preparePhyPayload(PhyPayload, MPDU, MPDU_Length, MMODE);
 
 		/*
-		 * Copy data to local buffer and set fields
+		 * Do the convolutional encoding and the interleaving burst by burst.
+		 * Each radio burst gathers its 24 coded bits directly from the whitened
+		 * payload, so that the bursts can be written with a few byte stores
+		 * instead of scattering every single coded bit. The midamble and the
+		 * differential MSK encoding are added in the same step.
 		 */
-		uint8_t PhyPayload[numBursts];
-		for (uint16_t i = 0; i < MPDU_Length; ++i) {
-			PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS + i] = MPDU[i];
+		for (uint16_t burstIdx = 0; burstIdx < numBursts; ++burstIdx) {
+			encodeRadioBurst(&RadioBursts[burstIdx], PhyPayload, numBursts, burstIdx);
 		}
-		PhyPayload[TSUNBPHY_PAYLOAD_PSI_POS] = (uint8_t)MPDU_Length;
 
 
-		// The MMODE is copied at the end of the payload data for CRC calculation.
-		// It is copied to the correct position if stuffing is required later.
-		PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS + MPDU_Length] = (MMODE & 0x03) << 6;
+		/*
+		 * Add the TSMA pattern
+		 */
+		if (TSUNB_UPG == TsUnb_UPG3) {
+			addTsmaPattern(numBursts, 0, lfsrSeed, RadioBursts);
+		}
+		else {
+			addTsmaPattern(numBursts, TSMAPattern % TSUNBPHY_UNB_NUM_P,
+					lfsrSeed, RadioBursts);
+		}
 
-		// Calculate the payload CRC
-		PhyPayload[TSUNBPHY_PAYLOAD_CRC_POS] =
-				calcCRC8(&PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS], MPDU_Length * 8 + 2);
+		/*
+		 * Return frequency f_0
+		 */
+		return calcFreqReg((uint8_t)lfsrSeed);
+	}
 
 
-		// Stuff in case of short PSDU and bring the MMODE to the right position
-		if (MPDU_Length < TSUNBPHY_MIN_PSDU_LENGTH) {
-			// We have to stuff the data
-			for (uint16_t i = MPDU_Length;i < TSUNBPHY_MIN_PSDU_LENGTH; ++i) {
-				PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS + i] = 0;
-			}
+	/**
+	 * @brief Start the streaming encoding of a TS-UNB telegram
+	 *
+	 * This method prepares the streaming encoding of a TS-UNB telegram. In contrast to encode()
+	 * the radio bursts are not stored for the complete telegram. Instead, each radio burst is
+	 * generated on demand by getNextRadioBurst(), e.g. just before it is transmitted. Therefore,
+	 * only the PHY payload has to be kept in memory and the required memory no longer scales
+	 * with the number of radio bursts.
+	 *
+	 * @param	PhyPayload	Pointer to already allocated memory for the PHY payload. The length of the array can be calculated using the numRadioBursts() method. It must remain valid until the last radio burst has been generated.
+	 * @param	MPDU		Pointer to MPDU input data
+	 * @param	MPDU_Length	MPDU length in bytes
+	 * @param	TSMAPattern	TSMA Pattern for the modulation, caution: index starts with 0 (standard starts with 1)
+	 * @param	MMODE       Used MacMode
+	 *
+	 * @return	Frequency f_0 of the radio bursts in register setting. Returns 0 in case of error.
+	 */
+	uint32_t beginEncode(uint8_t* const PhyPayload, const uint8_t* const MPDU,
+			const uint16_t MPDU_Length,	const uint8_t TSMAPattern = 0, const uint8_t MMODE = 0) {
+		streamNumBursts = 0;
+		streamBurstIdx = 0;
 
-			// Finally copy the MMODE to the right position at the end of the stuffing data
-			PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS + TSUNBPHY_MIN_PSDU_LENGTH] = (MMODE & 0x03) << 6;
-		}
+		if (MPDU_Length > TSUNBPHY_MAX_PSDU_LENGTH)
+			return 0;
 
-		// Calculate the header CRC
-		PhyPayload[TSUNBPHY_HEADER_CRC_POS] = calcCRC8(&PhyPayload[TSUNBPHY_PAYLOAD_CRC_POS], 16);
+		streamPayload = PhyPayload;
+		streamLfsrSeed = preparePhyPayload(PhyPayload, MPDU, MPDU_Length, MMODE);
+		streamNumBursts = numRadioBursts(MPDU_Length);
 
+		if (TSUNB_UPG == TsUnb_UPG3)
+			streamTsmaPattern = 0;
+		else
+			streamTsmaPattern = TSMAPattern % TSUNBPHY_UNB_NUM_P;
 
-		//! Payload CRC, later required as LFSR seed
-		const uint8_t payloadCrc = PhyPayload[TSUNBPHY_PAYLOAD_CRC_POS];
+		return calcFreqReg((uint8_t)streamLfsrSeed);
+	}
 
-		//! LFSR seed for burst positions in case of extension frame
-		uint16_t lfsrSeed =
-				0x8000u | (uint16_t) PhyPayload[TSUNBPHY_HEADER_CRC_POS] <<	8 | payloadCrc;
+
+	/**
+	 * @brief Start the streaming encoding of a TS-UNB telegram with the MPDU already in the PHY payload
+	 *
+	 * This method is identical to beginEncode(), except that the MPDU has already been written
+	 * to the PHY payload at the position TSUNBPHY_PAYLOAD_DATA_POS, e.g. directly by the MAC.
+	 * The PSI, the CRCs and the MMODE are added, and the data is whitened in place. This avoids
+	 * a separate MPDU buffer and its copy.
+	 *
+	 * @param	PhyPayload	Pointer to the PHY payload containing the MPDU at TSUNBPHY_PAYLOAD_DATA_POS. The length of the array can be calculated using the numRadioBursts() method. It must remain valid until the last radio burst has been generated.
+	 * @param	MPDU_Length	MPDU length in bytes
+	 * @param	TSMAPattern	TSMA Pattern for the modulation, caution: index starts with 0 (standard starts with 1)
+	 * @param	MMODE       Used MacMode
+	 *
+	 * @return	Frequency f_0 of the radio bursts in register setting. Returns 0 in case of error.
+	 */
+	uint32_t beginEncodeInPlace(uint8_t* const PhyPayload, const uint16_t MPDU_Length,
+			const uint8_t TSMAPattern = 0, const uint8_t MMODE = 0) {
+		return beginEncode(PhyPayload, &PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS], MPDU_Length, TSMAPattern, MMODE);
+	}
 
 
-		/*
-		 * Whiten the data
-		 */
-		whitenData(PhyPayload, numBursts);
+	/**
+	 * @brief Generate the next radio burst of the telegram started with beginEncode()
+	 *
+	 * This method generates the next radio burst including the convolutional encoding,
+	 * midamble insertion, MSK precoding and the TSMA pattern, i.e. the radio burst is
+	 * identical to the corresponding radio burst generated by encode().
+	 *
+	 * @param	RadioBurst	Pointer to the radio burst for the output
+	 *
+	 * @return	True if a radio burst was generated, false if all radio bursts have already been generated
+	 */
+	bool getNextRadioBurst(RadioBurst_T* const RadioBurst) {
+		if (streamBurstIdx >= streamNumBursts)
+			return false;
 
-		/*
-		 * Do the convolutional encoding.
-		 * The coding is quite complex due to the bit shift in the interleaver.
-		 * To minimize memory consumption the interleaving and the convolutional
-		 * encoding are done in a single step.
-		 */
-		//! Number of payload bits
-		const uint16_t payloadBits = numBursts * 8;
+		encodeRadioBurst(RadioBurst, streamPayload, streamNumBursts, streamBurstIdx);
+		setTsmaPattern(RadioBurst, streamNumBursts, streamBurstIdx, streamTsmaPattern, streamLfsrSeed);
 
-		//! Register for convolutional encoder
-		uint8_t convReg = 0;
+		++streamBurstIdx;
+		return true;
+	}
 
-		// The code termination is achieved by means of the zero bits in the MMODE field.
-		// Therefore we have to restore our tail bits that we lost during the whitening.
-		PhyPayload[numBursts - 1] &= 0xC0;
 
+#ifndef __AVR_ARCH__
+	/**
+	 * @brief Bit-sliced encoding of up to 64 TS-UNB telegrams
+	 *
+	 * This method encodes up to TSUNBPHY_NUM_LANES telegrams with identical MPDU length
+	 * in parallel. The PSDUs are transposed into bit planes, where each bit of a 64 bit
+	 * word belongs to another telegram. The CRCs, the whitening, the convolutional encoding
+	 * and the interleaving are then done for all telegrams at once. Finally, the data is
+	 * transposed back into the radio bursts of the individual telegrams.
+	 * The output is identical to calling encode() for each telegram.
+	 *
+	 * This method is intended for the bulk generation of telegrams on host systems and
+	 * requires approx. 17kB of stack memory. It is not available on AVR systems.
+	 *
+	 * @param	RadioBursts		Array of pointers to the already allocated radio bursts of each telegram. The length of each array can be calculated using the numRadioBursts() method.
+	 * @param	freqRegs		Output array for the frequency f_0 of each telegram in register setting
+	 * @param	MPDUs			Array of pointers to the MPDU input data of each telegram
+	 * @param	numTelegrams	Number of telegrams, at most TSUNBPHY_NUM_LANES
+	 * @param	MPDU_Length		MPDU length in bytes, identical for all telegrams
+	 * @param	TSMAPatterns	TSMA pattern of each telegram, caution: index starts with 0 (standard starts with 1)
+	 * @param	MMODE			Used MacMode
+	 *
+	 * @return	Number of encoded telegrams. Returns 0 in case of error.
+	 */
+	uint8_t encodeBitSliced(RadioBurst_T* const RadioBursts[], uint32_t* const freqRegs,
+			const uint8_t* const MPDUs[], const uint8_t numTelegrams, const uint16_t MPDU_Length,
+			const uint8_t* const TSMAPatterns, const uint8_t MMODE = 0) {
 
+		if (MPDU_Length > TSUNBPHY_MAX_PSDU_LENGTH)
+			return 0;
+		if (numTelegrams == 0 || numTelegrams > TSUNBPHY_NUM_LANES)
+			return 0;
 
-		// To avoid an additional memory for the cylic shift of the interleaver we
-		// use some kind of tail biting covolutional code. For this purpose we
-		// first have to bring the code to the correct register state.
-		for (uint16_t inBitIdx = 0; inBitIdx < 8; ++inBitIdx) {
-			convReg <<= 1;
+		const uint16_t numBursts = numRadioBursts(MPDU_Length);
 
-			const uint16_t shiftBitIdx = payloadBits + inBitIdx - (TSUNBPHY_NUM_BITS_SHIFT / 3 + 8);
-			if (readBit(shiftBitIdx, PhyPayload))
-				convReg |= 1;
+		//! Number of payload bits
+		const uint16_t payloadBits = numBursts * 8;
+
+		//! Bit planes of the PHY payload, bit 63 - i belongs to telegram i
+		uint64_t planes[(TSUNBPHY_MAX_PSDU_LENGTH + TSUNBPHY_OVERHEAD) * 8];
+		for (uint16_t i = 0; i < payloadBits; ++i) {
+			planes[i] = 0;
 		}
 
-		// Here we to the actual convolutional encoding
-		// We normally would have to reset the convolution encoder at the end
-		// of the payload data before starting to encode the initial header data,
-		// which is caused by the cyclic shift. However, the MMODE only takes 2 bits
-		// and we have 6 zeros in this byte. This actually terminates the code and
-		// we start again from zero.
-		for (uint16_t inBitIdx = 0; inBitIdx < payloadBits;	++inBitIdx) {
+		//! Temporary memory for the transposition
+		uint64_t matrix[TSUNBPHY_NUM_LANES];
 
-			// Consider bit shift due to the interleaver and correct if necessary
-			int16_t shiftBitIdx = (int16_t) inBitIdx - TSUNBPHY_NUM_BITS_SHIFT / 3;
-			if (shiftBitIdx < 0)
-				shiftBitIdx += payloadBits;
+		/*
+		 * Transpose the MPDUs into the bit planes, 8 bytes at a time
+		 */
+		for (uint16_t byteIdx = 0; byteIdx < MPDU_Length; byteIdx += 8) {
+			for (uint8_t lane = 0; lane < TSUNBPHY_NUM_LANES; ++lane) {
+				uint64_t row = 0;
+				for (uint16_t i = byteIdx; i < byteIdx + 8; ++i) {
+					row <<= 8;
+					if (lane < numTelegrams && i < MPDU_Length)
+						row |= MPDUs[lane][i];
+				}
+				matrix[lane] = row;
+			}
+			transposeBits64(matrix);
 
-			convReg <<= 1;
-			if (readBit(shiftBitIdx, PhyPayload))
-				convReg |= 1;
+			for (uint16_t i = 0; i < 64 && byteIdx * 8 + i < MPDU_Length * 8; ++i) {
+				planes[(TSUNBPHY_PAYLOAD_DATA_POS + byteIdx) * 8 + i] = matrix[i];
+			}
+		}
+		setBitSlicedByte(planes, TSUNBPHY_PAYLOAD_PSI_POS, (uint8_t)MPDU_Length);
 
 
-			// Get the one output from each branch of the convolutional encoder
-			uint8_t outBits[3];
-			outBits[0] = convEncode_parity(TSUNBPHY_CONV_POLY_G1 & convReg);
-			outBits[1] = convEncode_parity(TSUNBPHY_CONV_POLY_G2 & convReg);
-			outBits[2] = convEncode_parity(TSUNBPHY_CONV_POLY_G3 & convReg);
+		// The MMODE is copied at the end of the payload data for CRC calculation.
+		// It is copied to the correct position if stuffing is required later.
+		setBitSlicedByte(planes, TSUNBPHY_PAYLOAD_DATA_POS + MPDU_Length, (MMODE & 0x03) << 6);
 
-			// And write the bits directly onto their correct positions on the radio bursts
-			for (uint8_t i = 0; i < 3; ++i) {
-				uint16_t outBitIdx = inBitIdx * 3 + i;
-				const uint16_t burstIdx = getRadioBurstIdx(outBitIdx, numBursts);
-				RadioBursts[burstIdx].writeSubPacketBit(outBits[i], burstIdx);
-			}
+		// Calculate the payload CRC
+		calcCRC8BitSliced(&planes[TSUNBPHY_PAYLOAD_CRC_POS * 8],
+				&planes[TSUNBPHY_PAYLOAD_DATA_POS * 8], MPDU_Length * 8 + 2);
+
+		// Stuff in case of short PSDU and bring the MMODE to the right position
+		if (MPDU_Length < TSUNBPHY_MIN_PSDU_LENGTH) {
+			setBitSlicedByte(planes, TSUNBPHY_PAYLOAD_DATA_POS + MPDU_Length, 0);
+			setBitSlicedByte(planes, TSUNBPHY_PAYLOAD_DATA_POS + TSUNBPHY_MIN_PSDU_LENGTH, (MMODE & 0x03) << 6);
 		}
 
+		// Calculate the header CRC
+		calcCRC8BitSliced(&planes[TSUNBPHY_HEADER_CRC_POS * 8],
+				&planes[TSUNBPHY_PAYLOAD_CRC_POS * 8], 16);
+
 
 		/*
-		 * Add the midamble and do the differntial MSK encoding
+		 * Get the CRCs of each telegram, required for the LFSR seed and the frequency
 		 */
-		for (uint16_t burstIdx = 0; burstIdx < numBursts; ++burstIdx) {
-			RadioBursts[burstIdx].addMidamble(burstIdx);
-			RadioBursts[burstIdx].differentialMSKEncoding();
+		uint8_t headerCrc[TSUNBPHY_NUM_LANES];
+		uint8_t payloadCrc[TSUNBPHY_NUM_LANES];
+		for (uint8_t lane = 0; lane < numTelegrams; ++lane) {
+			headerCrc[lane] = 0;
+			payloadCrc[lane] = 0;
+			for (uint8_t i = 0; i < 8; ++i) {
+				headerCrc[lane] = (headerCrc[lane] << 1) |
+						((planes[TSUNBPHY_HEADER_CRC_POS * 8 + i] >> (63 - lane)) & 1);
+				payloadCrc[lane] = (payloadCrc[lane] << 1) |
+						((planes[TSUNBPHY_PAYLOAD_CRC_POS * 8 + i] >> (63 - lane)) & 1);
+			}
 		}
 
 
 		/*
-		 * Add the TSMA pattern
+		 * Whiten the data, the whitening sequence is identical for all telegrams
 		 */
-		if (TSUNB_UPG == TsUnb_UPG3) {
-			addTsmaPattern(numBursts, 0, lfsrSeed, RadioBursts);
+		uint8_t whitening[TSUNBPHY_MAX_PSDU_LENGTH + TSUNBPHY_OVERHEAD];
+		for (uint16_t i = 0; i < numBursts; ++i) {
+			whitening[i] = 0;
 		}
-		else {
-			addTsmaPattern(numBursts, TSMAPattern % TSUNBPHY_UNB_NUM_P,
-					lfsrSeed, RadioBursts);
+		whitenData(whitening, numBursts);
+
+		for (uint16_t i = 0; i < payloadBits; ++i) {
+			if (readBit(i, whitening))
+				planes[i] = ~planes[i];
+		}
+
+		// The code termination is achieved by means of the zero bits in the MMODE field.
+		// Therefore we have to restore our tail bits that we lost during the whitening.
+		for (uint16_t i = payloadBits - 6; i < payloadBits; ++i) {
+			planes[i] = 0;
 		}
 
+
 		/*
-		 * Return frequency f_0
+		 * Do the convolutional encoding and the interleaving burst by burst
+		 * and transpose the result back into the radio bursts
 		 */
-		return calcFreqReg(payloadCrc);
+		for (uint16_t burstIdx = 0; burstIdx < numBursts; ++burstIdx) {
+			BitSlicedBitSink Sink(planes, payloadBits, matrix);
+			deinterleaveRadioBurst(numBursts, burstIdx, Sink);
+
+			for (uint8_t i = TSUNB_RADIO_BURST_DATA_LEN; i < TSUNBPHY_NUM_LANES; ++i) {
+				matrix[i] = 0;
+			}
+			transposeBits64(matrix);
+
+			// Data bits 0...11 are in the bits 63...52, data bits 24...35 in the bits 51...40
+			for (uint8_t lane = 0; lane < numTelegrams; ++lane) {
+				RadioBurst_T* const RadioBurst = &RadioBursts[lane][burstIdx];
+				RadioBurst->writeSubPacketMSK((uint16_t)(matrix[lane] >> 52), (uint16_t)(matrix[lane] >> 40), burstIdx);
+			}
+		}
+
+
+		/*
+		 * Add the TSMA pattern and return the frequencies f_0
+		 */
+		for (uint8_t lane = 0; lane < numTelegrams; ++lane) {
+			const uint16_t lfsrSeed = 0x8000u | (uint16_t) headerCrc[lane] << 8 | payloadCrc[lane];
+
+			if (TSUNB_UPG == TsUnb_UPG3) {
+				addTsmaPattern(numBursts, 0, lfsrSeed, RadioBursts[lane]);
+			}
+			else {
+				addTsmaPattern(numBursts, TSMAPatterns[lane] % TSUNBPHY_UNB_NUM_P,
+						lfsrSeed, RadioBursts[lane]);
+			}
+
+			freqRegs[lane] = calcFreqReg(payloadCrc[lane]);
+		}
+
+		return numTelegrams;
+	}
+#endif
+
+
+	/**
+	 * @brief Calculate the transmission schedule of the radio bursts
+	 *
+	 * This method calculates the absolute start time of each radio burst in timer ticks
+	 * and the frequency register value of each radio burst. This allows the transmitter
+	 * to precalculate all time and frequency values before the first radio burst, so that
+	 * only the values have to be copied during the transmission.
+	 *
+	 * @param	Schedule			Pointer to already allocated array for the schedule with one entry per radio burst
+	 * @param	RadioBursts			Pointer to the encoded radio bursts
+	 * @param	numBursts			Number of radio bursts
+	 * @param	frequency			Frequency f_0 of the radio bursts in register setting as returned by encode()
+	 * @param	ticksPerSymbolQ16	Duration of a symbol in timer ticks as Q16.16 fixed point value
+	 *
+	 */
+	void encodeSchedule(TxScheduleEntry* const Schedule, const RadioBurst_T* const RadioBursts,
+			const uint16_t numBursts, const uint32_t frequency, const uint32_t ticksPerSymbolQ16) const {
+		//! Start time of the current radio burst in symbols
+		uint32_t startSymbol = 0;
+
+		for (uint16_t burstIdx = 0; burstIdx < numBursts; ++burstIdx) {
+			// Round to the nearest timer tick
+			const uint64_t startTick = ((uint64_t)startSymbol * ticksPerSymbolQ16 + 0x8000u) >> 16;
+			Schedule[burstIdx].startTick = (uint16_t)startTick;
+
+			const uint32_t freqReg = frequency + RadioBursts[burstIdx].getCarrierOffset();
+			Schedule[burstIdx].freqReg[0] = (uint8_t)(freqReg >> 16);
+			Schedule[burstIdx].freqReg[1] = (uint8_t)(freqReg >> 8);
+			Schedule[burstIdx].freqReg[2] = (uint8_t)freqReg;
+
+			startSymbol += RadioBursts[burstIdx].get_T_RB();
+		}
 	}
 
 
 	/** 
 	 * Returns number of radio bursts as function of the payloadLength
-	 * Return 0 in case of error
+	 * Return 0 in case of error, can be evaluated at compile time to size the buffers
 	 */ 
-	uint16_t numRadioBursts(const uint16_t MPDU_Length) const {
-		if (MPDU_Length > TSUNBPHY_MAX_PSDU_LENGTH)
-			return 0;
-
-		if (MPDU_Length < TSUNBPHY_MIN_PSDU_LENGTH)
-			return TSUNBPHY_MIN_PSDU_LENGTH + TSUNBPHY_OVERHEAD;
-		else
-			return MPDU_Length + TSUNBPHY_OVERHEAD;
-
+	static constexpr uint16_t numRadioBursts(const uint16_t MPDU_Length) {
+		return MPDU_Length > TSUNBPHY_MAX_PSDU_LENGTH ? 0 :
+				MPDU_Length < TSUNBPHY_MIN_PSDU_LENGTH ? TSUNBPHY_MIN_PSDU_LENGTH + TSUNBPHY_OVERHEAD :
+				MPDU_Length + TSUNBPHY_OVERHEAD;
 	}
 
 	/** 
@@ -415,6 +833,9 @@ public:
 	 */ 
 	void encodeSyncBurst(RadioBurst_T* const RadioBurst, const uint8_t TSMAPattern, const uint8_t LSB_ShortAddress) {
 		
+		// The head bits are not overwritten, so the radio burst is cleared first to allow for its reuse
+		*RadioBurst = RadioBurst_T();
+
 		// Data array for the Sync Burst
 		// Note: The TSMAPattern rages from 0 (p=1) to 7 (p=8)
 		uint8_t syncBurst[5] = {0x33, 0x3d, (uint8_t)(0x30 + (TSMAPattern & 0x07)), LSB_ShortAddress, 0};
@@ -459,15 +880,7 @@ public:
 		RadioBurst->differentialMSKEncoding();
 		RadioBurst->setCarrierOffset((uint16_t)24 * B_c);
 		
-		switch (TSUNB_UPG) {
-		case TsUnb_UPG1:
-		case TsUnb_UPG2:
-			RadioBurst->set_T_RB(337);
-			break;
-		case TsUnb_UPG3:
-			RadioBurst->set_T_RB(66);
-			break;
-		}		
+		RadioBurst->set_T_RB(TsmaPatternTable<TSUNB_UPG>::TIME_SPACING);
 
 		return;
 	}
@@ -501,6 +914,74 @@ public:
 
 
 private:
+	/**
+	 * @brief Prepare the PHY payload for the encoding
+	 *
+	 * This method copies the MPDU into the PHY payload, adds the PSI, the CRCs and the
+	 * MMODE, does the stuffing and whitens the data. The copy is skipped if the MPDU is
+	 * already located in the PHY payload.
+	 *
+	 * @param	PhyPayload	Pointer to the PHY payload with a length of numRadioBursts(MPDU_Length) bytes
+	 * @param	MPDU		Pointer to MPDU input data, may be &PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS]
+	 * @param	MPDU_Length	MPDU length in bytes
+	 * @param	MMODE       Used MacMode
+	 *
+	 * @return	LFSR seed for the extension frame, the LSB is the payload CRC
+	 */
+	uint16_t preparePhyPayload(uint8_t* const PhyPayload, const uint8_t* const MPDU,
+			const uint16_t MPDU_Length, const uint8_t MMODE) const {
+		const uint16_t numBursts = numRadioBursts(MPDU_Length);
+
+		if (MPDU != &PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS]) {
+			for (uint16_t i = 0; i < MPDU_Length; ++i) {
+				PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS + i] = MPDU[i];
+			}
+		}
+		PhyPayload[TSUNBPHY_PAYLOAD_PSI_POS] = (uint8_t)MPDU_Length;
+
+
+		// The MMODE is copied at the end of the payload data for CRC calculation.
+		// It is copied to the correct position if stuffing is required later.
+		PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS + MPDU_Length] = (MMODE & 0x03) << 6;
+
+		// Calculate the payload CRC
+		PhyPayload[TSUNBPHY_PAYLOAD_CRC_POS] =
+				calcCRC8(&PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS], MPDU_Length * 8 + 2);
+
+
+		// Stuff in case of short PSDU and bring the MMODE to the right position
+		if (MPDU_Length < TSUNBPHY_MIN_PSDU_LENGTH) {
+			// We have to stuff the data
+			for (uint16_t i = MPDU_Length;i < TSUNBPHY_MIN_PSDU_LENGTH; ++i) {
+				PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS + i] = 0;
+			}
+
+			// Finally copy the MMODE to the right position at the end of the stuffing data
+			PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS + TSUNBPHY_MIN_PSDU_LENGTH] = (MMODE & 0x03) << 6;
+		}
+
+		// Calculate the header CRC
+		PhyPayload[TSUNBPHY_HEADER_CRC_POS] = calcCRC8(&PhyPayload[TSUNBPHY_PAYLOAD_CRC_POS], 16);
+
+
+		//! LFSR seed for burst positions in case of extension frame
+		const uint16_t lfsrSeed = 0x8000u | (uint16_t) PhyPayload[TSUNBPHY_HEADER_CRC_POS] << 8 |
+				PhyPayload[TSUNBPHY_PAYLOAD_CRC_POS];
+
+
+		/*
+		 * Whiten the data
+		 */
+		whitenData(PhyPayload, numBursts);
+
+		// The code termination is achieved by means of the zero bits in the MMODE field.
+		// Therefore we have to restore our tail bits that we lost during the whitening.
+		PhyPayload[numBursts - 1] &= 0xC0;
+
+		return lfsrSeed;
+	}
+
+
 	/**
 	 * @brief Calculation of CRC8
 	 *
@@ -592,311 +1073,454 @@ private:
 	}
 
 
-	uint16_t getRadioBurstIdx(const uint16_t bitIdx, const uint16_t numPackets) const {
-		if (bitIdx < TSUNBPHY_NUM_BITS_CORE_ILV) {	// Core frame (first 288 bit)
-			return bitIdx % TSUNBPHY_NUM_CORE_BURSTS;
+	/**
+	 * @brief Returns the register state of the convolutional encoder
+	 *
+	 * This method returns the 7 bit register state of the convolutional encoder
+	 * after shifting in the input bit inBitIdx. The cyclic shift of the interleaver
+	 * is already considered, i.e. the bits are read cyclically from the payload
+	 * starting TSUNBPHY_NUM_BITS_SHIFT / 3 bits earlier.
+	 *
+	 * @param	PhyPayload	Pointer to the whitened PHY payload
+	 * @param	payloadBits	Number of payload bits
+	 * @param	inBitIdx	Index of the input bit of the convolutional encoder
+	 *
+	 * @return	Register state with the most recent bit as LSB
+	 *
+	 */
+	uint8_t convEncode_reg(const uint8_t* const PhyPayload, const uint16_t payloadBits,
+			const uint16_t inBitIdx) const {
+		int16_t startBitIdx = (int16_t) inBitIdx - TSUNBPHY_NUM_BITS_SHIFT / 3 - TSUNBPHY_CONV_POLY_M;
+		if (startBitIdx < 0)
+			startBitIdx += payloadBits;
+
+		// Fast path, the 7 bits are contained in two consecutive bytes
+		if (startBitIdx + TSUNBPHY_CONV_POLY_M < payloadBits) {
+			const uint16_t byteIdx = (uint16_t) startBitIdx >> 3;
+			const uint8_t intraByteIdx = startBitIdx & 0x07;
+
+			uint16_t reg = (uint16_t) PhyPayload[byteIdx] << 8;
+			if (intraByteIdx > 1)
+				reg |= PhyPayload[byteIdx + 1];
+
+			return (uint8_t) (reg >> (9 - intraByteIdx)) & 0x7F;
 		}
-		else {		// Extension frame
-			uint16_t groupIdx = bitIdx - TSUNBPHY_NUM_BITS_CORE_ILV;
-			const uint16_t groupLen =
-					numPackets - (TSUNBPHY_NUM_CORE_BURSTS >> 1);
 
-			const uint16_t group = groupIdx / groupLen;
-			groupIdx -= group * groupLen;
+		// Slow path at the wrap-around of the cyclic shift
+		uint8_t reg = 0;
+		for (uint8_t i = 0; i <= TSUNBPHY_CONV_POLY_M; ++i) {
+			uint16_t bitIdx = startBitIdx + i;
+			if (bitIdx >= payloadBits)
+				bitIdx -= payloadBits;
 
-			if (groupIdx < (TSUNBPHY_NUM_CORE_BURSTS >> 1))	// First 12 bit
-				return (groupIdx << 1) + (group & 1);
-			else
-				return groupIdx + (TSUNBPHY_NUM_CORE_BURSTS >> 1);
+			reg <<= 1;
+			reg |= readBit(bitIdx, PhyPayload);
 		}
+		return reg;
 	}
 
 
 	/**
-	 * @brief Add the TSMA pattern to the radio bursts
-	 *
-	 * This method adds the TSMA pattern to the radio bursts, i.e. configure
-	 * the T_RB and the C_RB.
-	 *
-	 * @param	numBursts		Number of radio bursts
-	 * @param	TSMAPattern		The selected TSMA pattern
-	 * @param	lfsrSeed		The seed of the LFSR generator (required for extension frames)
-	 * @param	RadioBursts		Pointer to radio burst memory
+	 * @brief Sink for the coded bits of a single radio burst
 	 *
+	 * This class calculates the coded bits of a radio burst out of the whitened
+	 * PHY payload and collects them in their order within the radio burst.
 	 */
-	void addTsmaPattern(const uint16_t numBursts, const uint8_t TSMAPattern,
-			uint16_t lfsrSeed, RadioBurst_T* const RadioBursts) const {
+	class RadioBurstBitSink {
+	public:
+		RadioBurstBitSink(const Phy& Phy_, const uint8_t* const PhyPayload_, const uint16_t payloadBits_) :
+			phy(Phy_), PhyPayload(PhyPayload_), payloadBits(payloadBits_),
+			firstBits(0), firstMask(0x001), lastBits(0), lastMask(0x800) {
+		}
 
-		for (uint16_t i = 0; i < TSUNBPHY_NUM_CORE_BURSTS; ++i) {
-			RadioBursts[i].setCarrierOffset((uint16_t)get_C_RB(TSMAPattern, i) * B_c);
+		/**
+		 * @brief Calculate the coded bit and write it to the radio burst bits
+		 *
+		 * @param	inBitIdx	Input bit index of the convolutional encoder
+		 * @param	branch		Branch of the convolutional encoder
+		 * @param	lastHalf	True if the bit belongs to the data bits 24...35
+		 */
+		void writeBit(const uint16_t inBitIdx, const uint8_t branch, const bool lastHalf) {
+			const uint8_t convReg = phy.convEncode_reg(PhyPayload, payloadBits, inBitIdx);
 
-			if (i != TSUNBPHY_NUM_CORE_BURSTS - 1)
-				RadioBursts[i].set_T_RB(get_T_RB(TSMAPattern, i));
+			uint8_t bit;
+			switch (branch) {
+			case 0:
+				bit = phy.convEncode_parity(TSUNBPHY_CONV_POLY_G1 & convReg);
+				break;
+			case 1:
+				bit = phy.convEncode_parity(TSUNBPHY_CONV_POLY_G2 & convReg);
+				break;
+			default:
+				bit = phy.convEncode_parity(TSUNBPHY_CONV_POLY_G3 & convReg);
+				break;
+			}
+
+			if (lastHalf) {
+				if (bit)
+					lastBits |= lastMask;
+				lastMask >>= 1;
+			}
+			else {
+				if (bit)
+					firstBits |= firstMask;
+				firstMask <<= 1;
+			}
 		}
 
+		//! Reference to the PHY for the encoder methods
+		const Phy& phy;
 
-		for (uint16_t i = TSUNBPHY_NUM_CORE_BURSTS; i < numBursts; ++i) {
-			lfsrSeed = tsmaLfsr(lfsrSeed);
-			RadioBursts[i].setCarrierOffset(((lfsrSeed >> 8) % 25) * B_c);
+		//! Pointer to the whitened PHY payload
+		const uint8_t* const PhyPayload;
 
-			uint16_t extentionFrameTimeSpacing;
+		//! Number of payload bits
+		const uint16_t payloadBits;
 
-			switch (TSUNB_UPG) {
-			case TsUnb_UPG1:
-				extentionFrameTimeSpacing =	TSUNBPHY_TIME_SPACING_UPG1;
-				break;
+		//! Data bits 0...11 of the burst, the first bit is the MSB
+		uint16_t firstBits;
+		uint16_t firstMask;
 
-			case TsUnb_UPG2:
-				extentionFrameTimeSpacing =	TSUNBPHY_TIME_SPACING_UPG2;
-				break;
+		//! Data bits 24...35 of the burst, the first bit is the MSB
+		uint16_t lastBits;
+		uint16_t lastMask;
+	};
+
+
+#ifndef __AVR_ARCH__
+	/**
+	 * @brief Sink for the coded bits of a single radio burst of all bit-sliced telegrams
+	 *
+	 * This class calculates the coded bit planes of a radio burst out of the bit planes
+	 * of the whitened PHY payload. The planes of data bits 0...11 are written to the rows
+	 * 0...11 of the output matrix and the planes of data bits 24...35 to the rows 12...23.
+	 */
+	class BitSlicedBitSink {
+	public:
+		BitSlicedBitSink(const uint64_t* const planes_, const uint16_t payloadBits_, uint64_t* const matrix_) :
+			planes(planes_), payloadBits(payloadBits_), matrix(matrix_), firstIdx(11), lastIdx(12) {
+		}
 
-			case TsUnb_UPG3:
-				extentionFrameTimeSpacing =	TSUNBPHY_TIME_SPACING_UPG3;
+		/**
+		 * @brief Calculate the coded bit plane and write it to the output matrix
+		 *
+		 * @param	inBitIdx	Input bit index of the convolutional encoder
+		 * @param	branch		Branch of the convolutional encoder
+		 * @param	lastHalf	True if the bit belongs to the data bits 24...35
+		 */
+		void writeBit(const uint16_t inBitIdx, const uint8_t branch, const bool lastHalf) {
+			uint8_t poly;
+			switch (branch) {
+			case 0:
+				poly = TSUNBPHY_CONV_POLY_G1;
+				break;
+			case 1:
+				poly = TSUNBPHY_CONV_POLY_G2;
+				break;
+			default:
+				poly = TSUNBPHY_CONV_POLY_G3;
 				break;
 			}
 
-			RadioBursts[i -	1].set_T_RB(extentionFrameTimeSpacing +	(lfsrSeed % 128));
+			// The bit planes of the register state, the most recent bit corresponds to the LSB of the polynomial
+			int16_t bitIdx = (int16_t) inBitIdx - TSUNBPHY_NUM_BITS_SHIFT / 3;
+			if (bitIdx < 0)
+				bitIdx += payloadBits;
+
+			uint64_t plane = 0;
+			for (uint8_t i = 0; i <= TSUNBPHY_CONV_POLY_M; ++i) {
+				if (poly & (1 << i))
+					plane ^= planes[bitIdx];
+				if (--bitIdx < 0)
+					bitIdx += payloadBits;
+			}
+
+			if (lastHalf)
+				matrix[lastIdx++] = plane;
+			else
+				matrix[firstIdx--] = plane;
 		}
 
-		RadioBursts[numBursts - 1].set_T_RB(0);
-	}
+		//! Bit planes of the whitened PHY payload
+		const uint64_t* const planes;
+
+		//! Number of payload bits
+		const uint16_t payloadBits;
+
+		//! Output matrix
+		uint64_t* const matrix;
+
+		//! Next row for the data bits 0...11
+		uint8_t firstIdx;
+
+		//! Next row for the data bits 24...35
+		uint8_t lastIdx;
+	};
 
 
 	/**
-	 * @brief Calculates the frequency register setting for the transmit frequency f_0
+	 * @brief Write a constant byte into the bit planes of all telegrams
 	 *
-	 * This method calculates the register setting to achieve the frequency f_0 in the
-	 * transmitter.
+	 * @param	planes		Pointer to the bit planes
+	 * @param	byteIdx		Position of the byte
+	 * @param	value		Value of the byte
 	 *
-	 * @param	payloadCrc		Payload CRC as the frequency depends on the CRC
+	 */
+	void setBitSlicedByte(uint64_t* const planes, const uint16_t byteIdx, const uint8_t value) const {
+		for (uint8_t i = 0; i < 8; ++i) {
+			if ((value << i) & 0x80)
+				planes[byteIdx * 8 + i] = ~(uint64_t)0;
+			else
+				planes[byteIdx * 8 + i] = 0;
+		}
+	}
+
+
+	/**
+	 * @brief Bit-sliced calculation of CRC8
 	 *
-	 * @return	Transmitter frequency register value for the frequency f_0
+	 * This method implements the CRC8 calculation of calcCRC8() for all bit-sliced telegrams.
+	 *
+	 * @param	crcPlanes		Pointer to the output memory for the 8 bit planes of the CRC, MSB first
+	 * @param	inputPlanes		Pointer to the input bit planes
+	 * @param	numInputBits	Number of input bits for the calcuation of the CRC
 	 *
 	 */
-	uint32_t calcFreqReg(const uint8_t payloadCrc) const {
-		// Calculate frequency according to 6.4.7.1.1
-		uint32_t f_c;
+	void calcCRC8BitSliced(uint64_t* const crcPlanes, const uint64_t* const inputPlanes,
+			const uint16_t numInputBits) const {
+		//! CRC register, crc8_reg[i] contains the bit i, initialized with init state
+		uint64_t crc8_reg[8];
+		for (uint8_t i = 0; i < 8; ++i) {
+			crc8_reg[i] = ((TSUNBPHY_CRC8_INIT >> i) & 1) ? ~(uint64_t)0 : 0;
+		}
 
-		if ((payloadCrc & 0x80u) == 0)
-			f_c = CHAN_A;
-		else
-			f_c = CHAN_B;
+		for (uint16_t bitIdx = 0; bitIdx < numInputBits; ++bitIdx) {
+			const uint64_t msb = crc8_reg[7] ^ inputPlanes[bitIdx];
 
-		// The only valid values for nco are 3 and 11
-		const int8_t v_c0 = (int8_t) (payloadCrc & 0x7Fu);
-		const int32_t C_RF = (v_c0 % n_co) - (n_co >> 1);
-		const uint32_t f_0 = f_c - 12 * B_c + C_RF * B_c0;
+			for (uint8_t i = 7; i > 0; --i) {
+				crc8_reg[i] = crc8_reg[i - 1];
+				if ((TSUNBPHY_CRC8_POLY >> i) & 1)
+					crc8_reg[i] ^= msb;
+			}
+			crc8_reg[0] = (TSUNBPHY_CRC8_POLY & 1) ? msb : 0;
+		}
 
-		return f_0;
+		for (uint8_t i = 0; i < 8; ++i) {
+			crcPlanes[i] = crc8_reg[7 - i];
+		}
 	}
+#endif
 
 
 	/**
-	 * @brief Returns radio burst time set of uplink T_rb according to 6.4.7.1.6.1
+	 * @brief Iterate over the coded bits of a single radio burst
 	 *
-	 * @param	TSMAPattern		Used TSMA pattern
-	 * @param	burstIdx		Number of the burst
+	 * This method implements the inverse of the frame interleaving of the coded bits onto
+	 * the radio bursts and of the sub-packet interleaving of the radio burst. It determines
+	 * for each of the 24 data bits of the radio burst the corresponding output bit of the
+	 * convolutional encoder and passes it to the method writeBit(inBitIdx, branch, lastHalf) of the sink. The bits are passed
+	 * in the same order as they would have been written using writeSubPacketBit().
 	 *
-	 * @return	Radio burst time set T_RB
+	 * @param	numBursts	Number of radio bursts
+	 * @param	burstIdx	Index of the radio burst
+	 * @param	Sink		Sink for the coded bits
 	 *
 	 */
-	uint16_t get_T_RB(const uint8_t TSMAPattern, const uint16_t burstIdx) const {
-		// Just to be sure
-		if (burstIdx >= 24)
-			return 0;
-		if (TSMAPattern >= 8)
-			return 0;
-
-		switch (TSUNB_UPG) {
-		case TsUnb_UPG1:{
-			// We use this uplink pattern
-			//{{330, 387, 388, 330, 387, 354, 330, 387, 356, 330, 387, 432, 330, 387, 352, 330, 387, 467, 330, 387, 620, 330, 387},
-			//{330, 387, 435, 330, 387, 409, 330, 387, 398, 330, 387, 370, 330, 387, 361, 330, 387, 472, 330, 387, 522, 330, 387},
-			//{330, 387, 356, 330, 387, 439, 330, 387, 413, 330, 387, 352, 330, 387, 485, 330, 387, 397, 330, 387, 444, 330, 387},
-			//{330, 387, 352, 330, 387, 382, 330, 387, 381, 330, 387, 365, 330, 387, 595, 330, 387, 604, 330, 387, 352, 330, 387},
-			//{330, 387, 380, 330, 387, 634, 330, 387, 360, 330, 387, 393, 330, 387, 352, 330, 387, 373, 330, 387, 490, 330, 387},
-			//{330, 387, 364, 330, 387, 375, 330, 387, 474, 330, 387, 355, 330, 387, 478, 330, 387, 464, 330, 387, 513, 330, 387},
-			//{330, 387, 472, 330, 387, 546, 330, 387, 501, 330, 387, 356, 330, 387, 359, 330, 387, 359, 330, 387, 364, 330, 387},
-			//{330, 387, 391, 330, 387, 468, 330, 387, 512, 330, 387, 543, 330, 387, 354, 330, 387, 391, 330, 387, 368, 330, 387}}
-
-			// For the TSMA uplink patterns only every 3rd position is different
-			const uint8_t burstIdxMod = ((uint8_t)burstIdx) % 3;
-			switch (burstIdxMod) {
-			case 0:
-				return 330;
-			case 1:
-				return 387;
-			case 2:
-				// Here we store the coefficients for every third position	
-				typedef uint16_t ETSI_TS_UNB_TRB_t[(TSUNBPHY_NUM_CORE_BURSTS - 1) / 3];
-				//! Time offset sequence for the non-identical delays of the TSMA uplink pattern of UPG1
-				const
-#ifdef __AVR_ARCH__
-						static PROGMEM
-#endif
-						ETSI_TS_UNB_TRB_t ETSI_TS_UNB_TRB_UPG1[TSUNBPHY_UNB_NUM_P] = {
-								{388, 354, 356, 432, 352, 467, 620},
-								{435, 409, 398, 370, 361, 472, 522},
-								{356, 439, 413, 352, 485, 397, 444},
-								{352, 382, 381, 365, 595, 604, 352},
-								{380, 634, 360, 393, 352, 373, 490},
-								{364, 375, 474, 355, 478, 464, 513},
-								{472, 546, 501, 356, 359, 359, 364},
-								{391, 468, 512, 543, 354, 391, 368}};
-
-#ifdef __AVR_ARCH__
-				return (uint16_t)pgm_read_word(&(ETSI_TS_UNB_TRB_UPG1[TSMAPattern][(uint8_t)burstIdx / 3]));
-#else
-				return ETSI_TS_UNB_TRB_UPG1[TSMAPattern][burstIdx / 3];
-#endif
+	template <class BitSink_T>
+	void deinterleaveRadioBurst(const uint16_t numBursts, const uint16_t burstIdx, BitSink_T& Sink) const {
+		//! Length of the interleaver groups of the extension frame
+		const uint16_t groupLen = numBursts - (TSUNBPHY_NUM_CORE_BURSTS >> 1);
+
+		uint8_t subPkgBitIdx = 0;
+		while (subPkgBitIdx < TSUNB_RADIO_BURST_DATA_LEN) {
+			// The output bits of a burst form up to two arithmetic sequences
+			uint16_t outBitIdx;
+			uint16_t outBitStep;
+			uint8_t subPkgBitEnd;
+
+			if (burstIdx >= TSUNBPHY_NUM_CORE_BURSTS) {
+				// Extension burst, one bit in each of the 24 groups
+				outBitIdx = TSUNBPHY_NUM_BITS_CORE_ILV + burstIdx - (TSUNBPHY_NUM_CORE_BURSTS >> 1);
+				outBitStep = groupLen;
+				subPkgBitEnd = TSUNB_RADIO_BURST_DATA_LEN;
+			}
+			else if (subPkgBitIdx == 0) {
+				// Core burst, first 12 bits from the core interleaver
+				outBitIdx = burstIdx;
+				outBitStep = TSUNBPHY_NUM_CORE_BURSTS;
+				subPkgBitEnd = TSUNB_RADIO_BURST_DATA_LEN / 2;
+			}
+			else {
+				// Core burst, last 12 bits from every second group of the extension frame
+				outBitIdx = TSUNBPHY_NUM_BITS_CORE_ILV + (burstIdx & 1) * groupLen + (burstIdx >> 1);
+				outBitStep = 2 * groupLen;
+				subPkgBitEnd = TSUNB_RADIO_BURST_DATA_LEN;
 			}
-		} break; 	// TsUnb_UPG1
-
-		case TsUnb_UPG2: {
-			// We use this uplink pattern
-			//{{373, 319, 545, 373, 319, 443, 373, 319, 349, 373, 319, 454, 373, 319, 578, 373, 319, 436, 373, 319, 398, 373, 319},
-			//{373, 319, 371, 373, 319, 410, 373, 319, 363, 373, 319, 354, 373, 319, 379, 373, 319, 657, 373, 319, 376, 373, 319},
-			//{373, 319, 414, 373, 319, 502, 373, 319, 433, 373, 319, 540, 373, 319, 428, 373, 319, 467, 373, 319, 409, 373, 319},
-			//{373, 319, 396, 373, 319, 516, 373, 319, 631, 373, 319, 471, 373, 319, 457, 373, 319, 416, 373, 319, 354, 373, 319},
-			//{373, 319, 655, 373, 319, 416, 373, 319, 367, 373, 319, 400, 373, 319, 415, 373, 319, 342, 373, 319, 560, 373, 319},
-			//{373, 319, 370, 373, 319, 451, 373, 319, 465, 373, 319, 593, 373, 319, 545, 373, 319, 380, 373, 319, 365, 373, 319},
-			//{373, 319, 393, 373, 319, 374, 373, 319, 344, 373, 319, 353, 373, 319, 620, 373, 319, 503, 373, 319, 546, 373, 319},
-			//{373, 319, 367, 373, 319, 346, 373, 319, 584, 373, 319, 579, 373, 319, 519, 373, 319, 351, 373, 319, 486, 373, 319}}
-			const uint8_t burstIdxMod = ((uint8_t)burstIdx) % 3;
-			switch (burstIdxMod) {
-			case 0:
-				return 373;
-			case 1:
-				return 319;
-			case 2:
-				// Here we store the coefficients for every third position	
-				typedef uint16_t ETSI_TS_UNB_TRB_t[(TSUNBPHY_NUM_CORE_BURSTS - 1) / 3];
-				//! Time offset sequence for the non-identical delays of the TSMA uplink pattern of UPG2
-				const
-#ifdef __AVR_ARCH__
-						static PROGMEM
-#endif
-						ETSI_TS_UNB_TRB_t ETSI_TS_UNB_TRB_UPG2[TSUNBPHY_UNB_NUM_P] = {
-								{545, 443, 349, 454, 578, 436, 398},
-								{371, 410, 363, 354, 379, 657, 376},
-								{414, 502, 433, 540, 428, 467, 409},
-								{396, 516, 631, 471, 457, 416, 354},
-								{655, 416, 367, 400, 415, 342, 560},
-								{370, 451, 465, 593, 545, 380, 365},
-								{393, 374, 344, 353, 620, 503, 546},
-								{367, 346, 584, 579, 519, 351, 486}};
 
-#ifdef __AVR_ARCH__
-				return (uint16_t)pgm_read_word(&(ETSI_TS_UNB_TRB_UPG2[TSMAPattern][burstIdx / 3]));
-#else
-				return ETSI_TS_UNB_TRB_UPG2[TSMAPattern][burstIdx / 3];
-#endif
+			uint16_t inBitIdx = outBitIdx / TSUNBPHY_CONV_RATE;
+			uint8_t branch = outBitIdx % TSUNBPHY_CONV_RATE;
+			const uint16_t inBitStep = outBitStep / TSUNBPHY_CONV_RATE;
+			const uint8_t branchStep = outBitStep % TSUNBPHY_CONV_RATE;
+
+			for (; subPkgBitIdx < subPkgBitEnd; ++subPkgBitIdx) {
+				// Interleaving within the radio burst
+				Sink.writeBit(inBitIdx, branch, (burstIdx ^ subPkgBitIdx) & 1);
+
+				inBitIdx += inBitStep;
+				branch += branchStep;
+				if (branch >= TSUNBPHY_CONV_RATE) {
+					branch -= TSUNBPHY_CONV_RATE;
+					++inBitIdx;
+				}
 			}
-		} break;	// TsUnb_UPG2
+		}
+	}
 
-		case TsUnb_UPG3: {
-			typedef uint8_t ETSI_TS_UNB_TRB_t[TSUNBPHY_NUM_CORE_BURSTS - 1];
-			//! Time offset sequence of the TSMA uplink pattern of UPG3
-			const
-#ifdef __AVR_ARCH__
-					static PROGMEM
-#endif
-					ETSI_TS_UNB_TRB_t ETSI_TS_UNB_TRB_UPG3[1] = {
-							{66, 66, 66, 66, 66, 66, 66, 66, 66, 123, 66, 66, 66, 66, 60, 66, 66, 198, 66, 66, 255, 66, 66}
-			};
 
-#ifdef __AVR_ARCH__
-			return (uint16_t)pgm_read_byte(&(ETSI_TS_UNB_TRB_UPG3[0][burstIdx]));
-#else
-			return ETSI_TS_UNB_TRB_UPG3[0][burstIdx];
-#endif
-		} break;	// TsUnb_UPG3
-		}
+	/**
+	 * @brief Encode the data bits of a single radio burst
+	 *
+	 * This method does the convolutional encoding and the interleaving for a single
+	 * radio burst and writes its 24 data bits together with the midamble. The radio
+	 * burst is already differentially MSK encoded.
+	 *
+	 * @param	RadioBurst	Pointer to the radio burst
+	 * @param	PhyPayload	Pointer to the whitened PHY payload
+	 * @param	numBursts	Number of radio bursts
+	 * @param	burstIdx	Index of the radio burst
+	 *
+	 */
+	void encodeRadioBurst(RadioBurst_T* const RadioBurst, const uint8_t* const PhyPayload,
+			const uint16_t numBursts, const uint16_t burstIdx) const {
+		RadioBurstBitSink Sink(*this, PhyPayload, numBursts * 8);
+		deinterleaveRadioBurst(numBursts, burstIdx, Sink);
 
-		return 0;	// We should normally never reach this point
+		RadioBurst->writeSubPacketMSK(Sink.firstBits, Sink.lastBits, burstIdx);
 	}
 
 
+	/**
+	 * @brief Add the TSMA pattern to the radio bursts
+	 *
+	 * This method adds the TSMA pattern to the radio bursts, i.e. configure
+	 * the T_RB and the C_RB.
+	 *
+	 * @param	numBursts		Number of radio bursts
+	 * @param	TSMAPattern		The selected TSMA pattern
+	 * @param	lfsrSeed		The seed of the LFSR generator (required for extension frames)
+	 * @param	RadioBursts		Pointer to radio burst memory
+	 *
+	 */
+	void addTsmaPattern(const uint16_t numBursts, const uint8_t TSMAPattern,
+			uint16_t lfsrSeed, RadioBurst_T* const RadioBursts) const {
+
+		for (uint16_t i = 0; i < numBursts; ++i) {
+			setTsmaPattern(&RadioBursts[i], numBursts, i, TSMAPattern, lfsrSeed);
+		}
+	}
+
 
 	/**
-	 * @brief Returns radio burst carrier set of uplink C_RB according to 6.4.7.1.6.1
+	 * @brief Add the TSMA pattern to a single radio burst
 	 *
-	 * @param	TSMAPattern		Used TSMA pattern
-	 * @param	burstIdx		Number of the burst
+	 * This method configures the C_RB and the T_RB of a single radio burst. It has to be
+	 * called for all radio bursts in ascending order, as the LFSR state for the extension
+	 * frame is updated.
 	 *
-	 * @return	Radio burst time set C_RB
+	 * @param	RadioBurst		Pointer to the radio burst
+	 * @param	numBursts		Number of radio bursts
+	 * @param	burstIdx		Index of the radio burst
+	 * @param	TSMAPattern		The selected TSMA pattern
+	 * @param	lfsrSeed		The state of the LFSR generator (required for extension frames), it is updated by this method
 	 *
 	 */
-	uint8_t get_C_RB(const uint8_t TSMAPattern, const uint16_t burstIdx) const {
-		typedef uint8_t ETSI_TS_UNB_CRB_t[TSUNBPHY_NUM_CORE_BURSTS];
+	void setTsmaPattern(RadioBurst_T* const RadioBurst, const uint16_t numBursts, const uint16_t burstIdx,
+			const uint8_t TSMAPattern, uint16_t& lfsrSeed) const {
 
-		switch (TSUNB_UPG) {
-		case TsUnb_UPG1: {
-			//! Carrier sequence of the TSMA uplink pattern of UPG1
-			const
-#ifdef __AVR_ARCH__
-		static PROGMEM
-#endif
-		ETSI_TS_UNB_CRB_t ETSI_TS_UNB_CRB_UPG1[TSUNBPHY_UNB_NUM_P] = {
-				{ 5, 21, 13,  6, 22, 14,  1, 17,  9,  0, 16,  8,  7, 23, 15,  4, 20, 12,  3, 19, 11,  2, 18, 10},
-				{ 4, 20, 12,  1, 17,  9,  0, 16,  8,  6, 22, 14,  7, 23, 15,  2, 18, 10,  5, 21, 13,  3, 19, 11},
-				{ 4, 20, 12,  3, 19, 11,  6, 22, 14,  7, 23, 15,  0, 16,  8,  5, 21, 13,  2, 18, 10,  1, 17,  9},
-				{ 6, 22, 14,  2, 18, 10,  7, 23, 15,  0, 16,  8,  1, 17,  9,  4, 20, 12,  5, 21, 13,  3, 19, 11},
-				{ 7, 23, 15,  4, 20, 12,  3, 19, 11,  2, 18, 10,  6, 22, 14,  0, 16,  8,  1, 17,  9,  5, 21, 13},
-				{ 3, 19, 11,  6, 22, 14,  2, 18, 10,  0, 16,  8,  7, 23, 15,  1, 17,  9,  4, 20, 12,  5, 21, 13},
-				{ 3, 19, 11,  1, 17,  9,  5, 21, 13,  7, 23, 15,  0, 16,  8,  2, 18, 10,  6, 22, 14,  4, 20, 12},
-				{ 0, 16,  8,  6, 22, 14,  3, 19, 11,  2, 18, 10,  4, 20, 12,  7, 23, 15,  5, 21, 13,  1, 17,  9}};
+		uint16_t entry = 0;
 
-#ifdef __AVR_ARCH__
-			return (uint8_t)pgm_read_byte(&(ETSI_TS_UNB_CRB_UPG1[TSMAPattern][burstIdx]));
-#else
-			return ETSI_TS_UNB_CRB_UPG1[TSMAPattern][burstIdx];
-#endif
-		} break; 	// TsUnb_UPG1
+		if (burstIdx < TSUNBPHY_NUM_CORE_BURSTS) {
+			entry = readTsmaEntry(TsmaPatternTable<TSUNB_UPG>::getPattern(TSMAPattern) + burstIdx);
+			RadioBurst->setCarrierOffset((uint16_t)(entry & TSUNBPHY_TSMA_CARRIER_MASK) * B_c);
+		}
+		else {
+			RadioBurst->setCarrierOffset(((lfsrSeed >> 8) % 25) * B_c);
+		}
 
-		case TsUnb_UPG2: {
-			//! Carrier sequence of the TSMA uplink pattern of UPG2
-			const
-#ifdef __AVR_ARCH__
-		static PROGMEM
-#endif
-		ETSI_TS_UNB_CRB_t ETSI_TS_UNB_CRB_UPG2[TSUNBPHY_UNB_NUM_P] = {
-				{ 4, 20, 12,  0, 16,  8,  3, 19, 11,  5, 21, 13,  1, 17,  9,  7, 23, 15,  2, 18, 10,  6, 22, 14},
-				{ 3, 19, 11,  7, 23, 15,  2, 18, 10,  5, 21, 13,  4, 20, 12,  0, 16,  8,  1, 17,  9,  6, 22, 14},
-				{ 6, 22, 14,  0, 16,  8,  1, 17,  9,  4, 20, 12,  3, 19, 11,  5, 21, 13,  2, 18, 10,  7, 23, 15},
-				{ 3, 19, 11,  1, 17,  9,  4, 20, 12,  5, 21, 13,  2, 18, 10,  7, 23, 15,  6, 22, 14,  0, 16,  8},
-				{ 5, 21, 13,  2, 18, 10,  0, 16,  8,  6, 22, 14,  7, 23, 15,  1, 17,  9,  4, 20, 12,  3, 19, 11},
-				{ 1, 17,  9,  3, 19, 11,  4, 20, 12,  6, 22, 14,  7, 23, 15,  5, 21, 13,  2, 18, 10,  0, 16,  8},
-				{ 5, 21, 13,  1, 17,  9,  2, 18, 10,  4, 20, 12,  3, 19, 11,  0, 16,  8,  6, 22, 14,  7, 23, 15},
-				{ 3, 19, 11,  6, 22, 14,  5, 21, 13,  1, 17,  9,  7, 23, 15,  2, 18, 10,  0, 16,  8,  4, 20, 12}};
+		// The time to the following burst
+		if (burstIdx + 1 >= numBursts) {
+			RadioBurst->set_T_RB(0);
+		}
+		else if (burstIdx + 1 < TSUNBPHY_NUM_CORE_BURSTS) {
+			RadioBurst->set_T_RB(entry >> TSUNBPHY_TSMA_TIME_SHIFT);
+		}
+		else {
+			lfsrSeed = tsmaLfsr(lfsrSeed);
+			RadioBurst->set_T_RB(TsmaPatternTable<TSUNB_UPG>::TIME_SPACING + (lfsrSeed % 128));
+		}
+	}
 
+
+	/**
+	 * @brief Reads a packed TSMA pattern entry
+	 *
+	 * @param	entry		Pointer to the entry, located in the program memory on AVR
+	 *
+	 * @return	Packed entry, see TSUNBPHY_TSMA_ENTRY
+	 *
+	 */
+	static uint16_t readTsmaEntry(const uint16_t* const entry) {
 #ifdef __AVR_ARCH__
-			return (uint8_t)pgm_read_byte(&(ETSI_TS_UNB_CRB_UPG2[TSMAPattern][burstIdx]));
+		return (uint16_t)pgm_read_word(entry);
 #else
-			return ETSI_TS_UNB_CRB_UPG2[TSMAPattern][burstIdx];
+		return *entry;
 #endif
-		} break;	// TsUnb_UPG2
+	}
 
-		case TsUnb_UPG3: {
-			//! Carrier sequence of the TSMA uplink pattern of UPG3
-			const
-#ifdef __AVR_ARCH__
-		static PROGMEM
-#endif
-		ETSI_TS_UNB_CRB_t ETSI_TS_UNB_CRB_UPG3[1] = {
-				{ 1, 5, 4, 3, 2, 17, 21, 20, 19, 18, 9, 13, 12, 11, 10, 6, 0, 7, 22, 16, 23, 14, 8, 15}};
 
-#ifdef __AVR_ARCH__
-			return (uint8_t)pgm_read_byte(&(ETSI_TS_UNB_CRB_UPG3[0][burstIdx]));
-#else
-			return ETSI_TS_UNB_CRB_UPG3[0][burstIdx];
-#endif
-		} break;	// TsUnb_UPG3
-		}
+	/**
+	 * @brief Calculates the frequency register setting for the transmit frequency f_0
+	 *
+	 * This method calculates the register setting to achieve the frequency f_0 in the
+	 * transmitter.
+	 *
+	 * @param	payloadCrc		Payload CRC as the frequency depends on the CRC
+	 *
+	 * @return	Transmitter frequency register value for the frequency f_0
+	 *
+	 */
+	uint32_t calcFreqReg(const uint8_t payloadCrc) const {
+		// Calculate frequency according to 6.4.7.1.1
+		uint32_t f_c;
+
+		if ((payloadCrc & 0x80u) == 0)
+			f_c = CHAN_A;
+		else
+			f_c = CHAN_B;
+
+		// The only valid values for nco are 3 and 11
+		const int8_t v_c0 = (int8_t) (payloadCrc & 0x7Fu);
+		const int32_t C_RF = (v_c0 % n_co) - (n_co >> 1);
+		const uint32_t f_0 = f_c - 12 * B_c + C_RF * B_c0;
 
-		return 0;	// We should normally never reach this point
+		return f_0;
 	}
-	
+
+
+	//! PHY payload of the streaming encoder
+	const uint8_t* streamPayload;
+
+	//! Number of radio bursts of the streaming encoder
+	uint16_t streamNumBursts;
+
+	//! Index of the next radio burst of the streaming encoder
+	uint16_t streamBurstIdx;
+
+	//! LFSR state of the streaming encoder
+	uint16_t streamLfsrSeed;
+
+	//! TSMA pattern of the streaming encoder
+	uint8_t streamTsmaPattern;
 
 };
 
@@ -105,6 +105,356 @@ namespace TsUnb {
 //! Number of data symbols for one TS-UNB radio burst
 #define TSUNB_RADIO_BURST_DATA_LEN		24
 
+//! Midamble of the core bursts, the first symbol is the MSB
+#define TSUNB_RADIO_BURST_MIDAMBLE_CORE	0x742
+
+//! Midamble of the extension bursts, the first symbol is the MSB
+#define TSUNB_RADIO_BURST_MIDAMBLE_EXT	0x4FA
+
+
+/**
+ * @brief	Data of Radio Bursts
+ *
+ * This template class contains the symbols of a radio burst for ETSI TS 103 357 TS-UNB
+ * and all methods to write them. It is the common base of the radio burst classes,
+ * which add the frequency and time information of the burst in different representations.
+ *
+ * The template parameter HEAD_BITS defines the number of head bits (2 are recommended).
+ *
+ * The template parameter TAIL_BITS defines the number of tail bits (2 are recommended).
+ *
+ */
+template<uint16_t HEAD_BITS = 2, uint16_t TAIL_BITS = 2>
+class RadioBurstData {
+public:
+	//! Total length of radio burst including head and tail bits
+	static const uint16_t BURST_LENGTH = HEAD_BITS + TAIL_BITS + TSUNB_RADIO_BURST_PAYLOAD_LEN;
+
+	//! total length of radio burst in bytes
+	static const uint16_t BURST_LENGTH_BYTES = (BURST_LENGTH + 7) / 8;
+
+	static_assert(BURST_LENGTH <= 64, "Radio burst including head and tail bits must not exceed 64 bits");
+
+	/**
+	 * @brief	Get pointer to radio burst data
+	 *
+	 * @return 	Pointer to radio burst data
+	 *
+	 */
+	const uint8_t* getBurst(void) const {
+		return data;
+	}
+
+	/**
+	 * @brief	Write bit to subpacket
+	 *
+	 * This method writes a bit to the correct position (includes interleaving)
+	 * in the subpacket. The index of the bit is counted by the caller.
+	 *
+	 * @param	bit			Value of the bit, i.e. 0 or 1
+	 * @param	burstIdx	Number of this radio burst in radio burst structure
+	 * @param	bitIdx		Number of the bit within the subpacket, i.e. number of previously written bits
+	 *
+	 */
+	void writeSubPacketBit(const uint8_t bit, const uint16_t burstIdx, const uint8_t bitIdx) {
+		writeBit(bit, getSubPkgBitIdx(burstIdx, bitIdx) + HEAD_BITS, data);
+	}
+
+	/**
+	 * @brief	Write all data bits and the midamble of the subpacket
+	 *
+	 * This method writes the complete radio burst at once, i.e. the 24 data bits,
+	 * the midamble and zeros for the head and tail bits. The data bits are already
+	 * expected in their final order, i.e. the interleaving has to be done by the caller.
+	 *
+	 * @param	firstBits	Data bits 0...11 of the subpacket, the first bit is the MSB
+	 * @param	lastBits	Data bits 24...35 of the subpacket, the first bit is the MSB
+	 * @param	burstIdx	Number of this radio burst in radio burst structure
+	 *
+	 */
+	void writeSubPacket(const uint16_t firstBits, const uint16_t lastBits, const uint16_t burstIdx) {
+#ifdef __AVR_ARCH__
+		uint32_t high, low;
+		getSubPacketImage(firstBits, lastBits, burstIdx, high, low);
+		storeBurst(high, low);
+#else
+		storeBurst(getSubPacketImage(firstBits, lastBits, burstIdx));
+#endif
+	}
+
+	/**
+	 * @brief	Write all data bits and the midamble of the subpacket with differential encoding
+	 *
+	 * This method is identical to writeSubPacket() followed by differentialMSKEncoding(),
+	 * but the differential encoding is done on the burst image before it is stored. Therefore,
+	 * the burst is written only once.
+	 *
+	 * @param	firstBits	Data bits 0...11 of the subpacket, the first bit is the MSB
+	 * @param	lastBits	Data bits 24...35 of the subpacket, the first bit is the MSB
+	 * @param	burstIdx	Number of this radio burst in radio burst structure
+	 *
+	 */
+	void writeSubPacketMSK(const uint16_t firstBits, const uint16_t lastBits, const uint16_t burstIdx) {
+#ifdef __AVR_ARCH__
+		uint32_t high, low;
+		getSubPacketImage(firstBits, lastBits, burstIdx, high, low);
+		low ^= (low >> 1) | (high << 31);
+		high ^= high >> 1;
+
+		// See differentialMSKEncoding()
+		if (HEAD_BITS > 0)
+			high |= (uint32_t) 1 << 31;
+
+		storeBurst(high, low);
+#else
+		uint64_t burst = getSubPacketImage(firstBits, lastBits, burstIdx);
+		burst ^= burst >> 1;
+
+		// See differentialMSKEncoding()
+		if (HEAD_BITS > 0)
+			burst |= (uint64_t) 1 << 63;
+
+		storeBurst(burst);
+#endif
+	}
+
+	/**
+	 * @brief	Write bit to subpacket at position Idx
+	 *
+	 * This method writes a bit to a specific position in the 
+	 * subpacket. This does NOT include the interleaving.
+	 * This method is intended for writing e.g. the Sync Burst bits. 
+	 * in the subpacket and increases its internal index.
+	 *
+	 * @param	bit			Value of the bit, i.e. 0 or 1
+	 * @param	bitIdx		Bit position in burst
+	 *
+	 */
+	void writeBitIdx(const uint8_t bit, const uint16_t bitIdx) {
+		writeBit(bit, bitIdx + HEAD_BITS, data);
+	}
+
+	/**
+	 * @brief	Add the midamble to the radio burst
+	 *
+	 * This method add the midable to the radio burst. It has to
+	 * be called after writing all bits. The midamble is written
+	 * with one masked byte operation per affected byte.
+	 *
+	 * @param	burstIdx	Number of this radio burst in radio burst structure
+	 */
+	void addMidamble(const uint16_t burstIdx) {
+		const bool core = burstIdx < TSUNB_RADIO_BURST_CORE_BURSTS;
+
+		for (uint16_t i = MIDAMBLE_FIRST_BYTE; i <= MIDAMBLE_LAST_BYTE; ++i) {
+			const uint8_t midamble = core ? getImageByte(getMidambleImage(true), i) : getImageByte(getMidambleImage(false), i);
+			data[i] = (data[i] & ~getImageByte(MIDAMBLE_MASK, i)) | midamble;
+		}
+	}
+
+	/**
+	 * @brief	Initialize the radio burst for writing the subpacket bit by bit
+	 *
+	 * This method initializes the radio burst from a precalculated image that
+	 * already contains the midamble. Therefore, addMidamble() is no longer required afterwards.
+	 *
+	 * @param	burstIdx	Number of this radio burst in radio burst structure
+	 */
+	void initSubPacket(const uint16_t burstIdx) {
+		const bool core = burstIdx < TSUNB_RADIO_BURST_CORE_BURSTS;
+
+#ifdef __AVR_ARCH__
+		storeBurst(core ? getMidambleWord(true, true) : getMidambleWord(false, true),
+				core ? getMidambleWord(true, false) : getMidambleWord(false, false));
+#else
+		for (uint16_t i = 0; i < BURST_LENGTH_BYTES; ++i) {
+			data[i] = core ? getImageByte(getMidambleImage(true), i) : getImageByte(getMidambleImage(false), i);
+		}
+#endif
+	}
+
+	/**
+	 * @brief	Differential encoding
+	 *
+	 * This method does the differential encoding. It
+	 * has to be called after adding the midamble.
+	 *
+	 */
+	void differentialMSKEncoding() {
+#ifdef __AVR_ARCH__
+		// 64 bit shifts are expensive on AVR, so the first four bytes are processed as
+		// a 32 bit word and the remaining bytes one after another
+		uint32_t word = ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint16_t) data[2] << 8) | data[3];
+		uint8_t firstBitLastByte = (uint8_t) (word << 7);
+		word ^= word >> 1;
+		data[0] = (uint8_t) (word >> 24);
+		data[1] = (uint8_t) (word >> 16);
+		data[2] = (uint8_t) (word >> 8);
+		data[3] = (uint8_t) word;
+
+		for(uint16_t s = 4; s < BURST_LENGTH_BYTES; ++s) {
+			const uint8_t shiftedData = firstBitLastByte | (data[s] >> 1);
+			firstBitLastByte = data[s] << 7;
+			data[s] ^= shiftedData;
+		}
+#else
+		uint64_t burst = 0;
+		for (uint16_t i = 0; i < BURST_LENGTH_BYTES; ++i) {
+			burst |= (uint64_t) data[i] << (56 - 8 * i);
+		}
+
+		storeBurst(burst ^ (burst >> 1));
+#endif
+		// The first and last two bits of each burst are don't cares
+		// Setting at least one initial bit to 1 is a workaround
+		if (HEAD_BITS > 0)
+			data[0] |= 0x80;
+	}
+
+protected:
+	/**
+	 * @brief Constructor
+	 *
+	 * Initializes the radio burst data with zeros
+	 */
+	RadioBurstData() {
+		for (uint16_t i = 0; i < BURST_LENGTH_BYTES; ++i) {
+			data[i] = 0;
+		}
+	}
+
+	//! Storage for radio burst data
+	uint8_t data[BURST_LENGTH_BYTES];
+
+private:
+	//! Shift of the midamble within a radio burst image
+	static const uint16_t MIDAMBLE_SHIFT = 64 - HEAD_BITS - TSUNB_RADIO_BURST_DATA_LEN;
+
+	//! Bits of the midamble within a radio burst image
+	static const uint64_t MIDAMBLE_MASK = (uint64_t) 0xFFF << MIDAMBLE_SHIFT;
+
+	//! Index of the first byte containing midamble bits
+	static const uint16_t MIDAMBLE_FIRST_BYTE = (HEAD_BITS + TSUNB_RADIO_BURST_DATA_LEN / 2) / 8;
+
+	//! Index of the last byte containing midamble bits
+	static const uint16_t MIDAMBLE_LAST_BYTE = (HEAD_BITS + TSUNB_RADIO_BURST_DATA_LEN / 2 + TSUNB_RADIO_BURST_MIDAMBLE_LEN - 1) / 8;
+
+	/**
+	 * @brief	Get the image of a radio burst that only contains the midamble
+	 *
+	 * @param	core		True for the midamble of the core bursts, false for the extension bursts
+	 *
+	 * @return	Radio burst image, the first bit is the MSB
+	 */
+	static constexpr uint64_t getMidambleImage(const bool core) {
+		return (uint64_t) (core ? TSUNB_RADIO_BURST_MIDAMBLE_CORE : TSUNB_RADIO_BURST_MIDAMBLE_EXT) << MIDAMBLE_SHIFT;
+	}
+
+	/**
+	 * @brief	Get a single byte of a radio burst image
+	 *
+	 * @param	image		Radio burst image, the first bit is the MSB
+	 * @param	byteIdx		Index of the byte
+	 *
+	 * @return	Byte byteIdx of the image
+	 */
+	static constexpr uint8_t getImageByte(const uint64_t image, const uint16_t byteIdx) {
+		return (uint8_t) (image >> (56 - 8 * byteIdx));
+	}
+
+	/**
+	 * @brief	Get the image of the complete subpacket
+	 *
+	 * @param	firstBits	Data bits 0...11 of the subpacket, the first bit is the MSB
+	 * @param	lastBits	Data bits 24...35 of the subpacket, the first bit is the MSB
+	 * @param	burstIdx	Number of this radio burst in radio burst structure
+	 *
+	 * @return	Radio burst including head and tail bits, the first bit is the MSB
+	 */
+	static uint64_t getSubPacketImage(const uint16_t firstBits, const uint16_t lastBits, const uint16_t burstIdx) {
+		const uint64_t burst = ((uint64_t) (firstBits & 0xFFF) << 24) | (lastBits & 0xFFF);
+		const uint64_t midamble = burstIdx < TSUNB_RADIO_BURST_CORE_BURSTS ? getMidambleImage(true) : getMidambleImage(false);
+		return (burst << (64 - HEAD_BITS - TSUNB_RADIO_BURST_PAYLOAD_LEN)) | midamble;
+	}
+
+	/**
+	 * @brief	Store a radio burst image
+	 *
+	 * @param	burst		Radio burst including head and tail bits, the first bit is the MSB
+	 */
+	void storeBurst(uint64_t burst) {
+		for (uint16_t i = 0; i < BURST_LENGTH_BYTES; ++i) {
+			data[i] = (uint8_t) (burst >> 56);
+			burst <<= 8;
+		}
+	}
+
+#ifdef __AVR_ARCH__
+	// 64 bit shifts are library calls on AVR, which loop over the bits. Therefore, the images
+	// are handled as two 32 bit words on AVR, which only need shifts by constants.
+
+	static_assert(MIDAMBLE_SHIFT + TSUNB_RADIO_BURST_MIDAMBLE_LEN >= 32, "The first data bits must be within the upper word of the image");
+
+	/**
+	 * @brief	Get one 32 bit word of the midamble image, see getMidambleImage()
+	 *
+	 * @param	core		True for the midamble of the core bursts, false for the extension bursts
+	 * @param	upper		True for the upper 32 bits of the image, false for the lower 32 bits
+	 *
+	 * @return	Word of the radio burst image
+	 */
+	static constexpr uint32_t getMidambleWord(const bool core, const bool upper) {
+		return (uint32_t) (upper ? getMidambleImage(core) >> 32 : getMidambleImage(core));
+	}
+
+	/**
+	 * @brief	Get the image of the complete subpacket as two 32 bit words, see getSubPacketImage()
+	 *
+	 * @param	high		Upper 32 bits of the image for the output
+	 * @param	low			Lower 32 bits of the image for the output
+	 */
+	static void getSubPacketImage(const uint16_t firstBits, const uint16_t lastBits, const uint16_t burstIdx,
+			uint32_t& high, uint32_t& low) {
+		const bool core = burstIdx < TSUNB_RADIO_BURST_CORE_BURSTS;
+
+		high = ((uint32_t) (firstBits & 0xFFF) << (MIDAMBLE_SHIFT + TSUNB_RADIO_BURST_MIDAMBLE_LEN - 32))
+				| ((uint32_t) (lastBits & 0xFFF) >> (32 - MIDAMBLE_SHIFT + TSUNB_RADIO_BURST_DATA_LEN / 2))
+				| (core ? getMidambleWord(true, true) : getMidambleWord(false, true));
+		low = ((uint32_t) (lastBits & 0xFFF) << (MIDAMBLE_SHIFT - TSUNB_RADIO_BURST_DATA_LEN / 2))
+				| (core ? getMidambleWord(true, false) : getMidambleWord(false, false));
+	}
+
+	/**
+	 * @brief	Store a radio burst image given as two 32 bit words
+	 *
+	 * @param	high		Upper 32 bits of the image, the first bit is the MSB
+	 * @param	low			Lower 32 bits of the image
+	 */
+	void storeBurst(uint32_t high, uint32_t low) {
+		for (uint16_t i = 0; i < BURST_LENGTH_BYTES; ++i) {
+			data[i] = (uint8_t) (high >> 24);
+			high = (high << 8) | (low >> 24);
+			low <<= 8;
+		}
+	}
+#endif
+
+	/**
+	 * @brief Function to calculate the sub-packet index for the data interleaving
+	 *
+	 * @param	burstIdx	Index of the radio burst
+	 * @param	bitIdx		Index of the bit within the burst
+	 *
+	 * @return	Position of the bit within the data[] array
+	 */
+	uint16_t getSubPkgBitIdx(const uint16_t burstIdx, const uint8_t bitIdx) const {
+		if((burstIdx ^ bitIdx) & 1) 		// (pkt even & bit odd) | (pkt odd & bit even)
+			return 24 + (bitIdx >> 1);		// 24 offset
+		else								// (pkt odd & bit odd) | (pkt even & bit even)
+			return 11 - (bitIdx >> 1);		// 11  offset
+	}
+};
+
 
 /**
  * @brief	Implementation of Radio Bursts
@@ -118,19 +468,22 @@ namespace TsUnb {
  * MSK decoding based on a matched filter. Therefore, two head bits and two tail bits
  * are recommended.
  *
+ * The symbols are handled by the base class RadioBurstData. This class stores the carrier
+ * offset and T_RB as 16 bit values each, where T_RB is also used as bit counter.
+ *
  * The template parameter HEAD_BITS defines the number of head bits (2 are recommended).
  *
  * The template parameter TAIL_BITS defines the number of tail bits (2 are recommended).
  *
  */
 template<uint16_t HEAD_BITS = 2, uint16_t TAIL_BITS = 2>
-class RadioBurst {
-public:
-	//! Total length of radio burst including head and tail bits
-	static const uint16_t BURST_LENGTH = HEAD_BITS + TAIL_BITS + TSUNB_RADIO_BURST_PAYLOAD_LEN;
+class RadioBurst : public RadioBurstData<HEAD_BITS, TAIL_BITS> {
+	//! Base class with the radio burst data
+	typedef RadioBurstData<HEAD_BITS, TAIL_BITS> Base;
 
-	//! total length of radio burst in bytes
-	static const uint16_t BURST_LENGTH_BYTES = (BURST_LENGTH + 7) / 8;
+public:
+	//! Step size of the carrier offsets that can be stored, any offset in transmitter register values
+	static const uint32_t CARRIER_STEP = 1;
 
 	/**
 	 * @brief Constructor
@@ -140,9 +493,6 @@ public:
 	RadioBurst() {
 		puncture();
 		T_RB = 0;
-		for (uint16_t i = 0; i < BURST_LENGTH_BYTES; ++i) {
-			data[i] = 0;
-		}
 	}
 
 	/**
@@ -153,7 +503,7 @@ public:
 	 */
 	uint16_t getBurstLength(void) const {
 		if (carrierOffset != 0xFFFF)
-			return BURST_LENGTH;
+			return Base::BURST_LENGTH;
 		else
 			return 0;
 	}
@@ -166,23 +516,11 @@ public:
 	 */
 	uint16_t getBurstLengthBytes(void) const {
 		if (carrierOffset != 0xFFFF)
-			return BURST_LENGTH_BYTES;
+			return Base::BURST_LENGTH_BYTES;
 		else
 			return 0;
 	}
 
-
-	/**
-	 * @brief	Get pointer to radio burst data
-	 *
-	 * @return 	Pointer to radio burst data
-	 *
-	 */
-	const uint8_t* getBurst(void) const {
-		return data;
-	}
-
-
 	/**
 	 * @brief	Write bit to subpacket
 	 *
@@ -196,27 +534,24 @@ public:
 	 *
 	 */
 	void writeSubPacketBit(const uint8_t bit, const uint16_t burstIdx) {
-		uint16_t bitIdx = getSubPkgBitIdx(burstIdx, T_RB);
-		writeBit(bit, bitIdx + HEAD_BITS, data);
+		Base::writeSubPacketBit(bit, burstIdx, (uint8_t) T_RB);
 		T_RB++;
 	}
 
 	/**
-	 * @brief	Write bit to subpacket at position Idx
-	 *
-	 * This method writes a bit to a specific position in the 
-	 * subpacket. This does NOT include the interleaving.
-	 * This method is intended for writing e.g. the Sync Burst bits. 
-	 * in the subpacket and increases its internal index.
+	 * @brief	Initialize the radio burst for writing the subpacket bit by bit
 	 *
-	 * @param	bit			Value of the bit, i.e. 0 or 1
-	 * @param	bitIdx		Bit position in burst
+	 * This method initializes the radio burst from a precalculated image that
+	 * already contains the midamble, and resets the bit counter of writeSubPacketBit().
+	 * Therefore, addMidamble() is no longer required afterwards.
 	 *
+	 * @param	burstIdx	Number of this radio burst in radio burst structure
 	 */
-	void writeBitIdx(const uint8_t bit, const uint16_t bitIdx) {
-		writeBit(bit, bitIdx + HEAD_BITS, data);
+	void initSubPacket(const uint16_t burstIdx) {
+		Base::initSubPacket(burstIdx);
+		T_RB = 0;
 	}
-	
+
 	/**
 	 * @brief	Set value T_RB
 	 *
@@ -274,105 +609,233 @@ public:
 	}
 
 	/**
-	 * @brief	Add the midamble to the radio burst
+	 * @brief	Puncture burst, i.e. it is not transmitted
+	 */
+	void puncture() {
+		carrierOffset = 0xFFFF;	
+	}
+
+private:
+	//! Offset in transmitter register values relative to the system frequency f_0
+	uint16_t carrierOffset;
+
+	//! Delay between start time of two radio burst, also internally used for number of written bits calculation in symbol durations
+	uint16_t T_RB;
+};
+
+
+/**
+ * @brief	Implementation of Radio Bursts with a compact representation
+ *
+ * This template class is a drop-in replacement for RadioBurst with a reduced memory
+ * footprint, e.g. for long telegrams on micro controllers with little RAM. Instead of
+ * the carrier offset in transmitter register values, only the carrier index C_RB (0...24)
+ * is stored. It is packed together with the puncture flag and T_RB into 16 bits,
+ * which reduces a RadioBurst<2,2> from 9 to 7 bytes on AVR. The bit counter of
+ * writeSubPacketBit() is not stored and has to be supplied by the caller.
+ *
+ * The template parameter HEAD_BITS defines the number of head bits (2 are recommended).
+ *
+ * The template parameter TAIL_BITS defines the number of tail bits (2 are recommended).
+ *
+ * The template parameter B_c is the carrier spacing step size as transmitter register setting.
+ * It has to be identical to the value used by the PHY, which is checked at compile time.
+ *
+ */
+template<uint16_t HEAD_BITS = 2, uint16_t TAIL_BITS = 2, uint32_t B_c = 39>
+class PackedRadioBurst : public RadioBurstData<HEAD_BITS, TAIL_BITS> {
+	//! Base class with the radio burst data
+	typedef RadioBurstData<HEAD_BITS, TAIL_BITS> Base;
+
+public:
+	//! Largest value of T_RB that can be stored
+	static const uint16_t MAX_T_RB = 0x3FF;
+
+	//! Step size of the carrier offsets that can be stored, the PHY checks that it matches its B_c
+	static const uint32_t CARRIER_STEP = B_c;
+
+	/**
+	 * @brief Constructor
 	 *
-	 * This method add the midable to the radio burst. It has to
-	 * be called after writing all bits.
+	 * Initializes radio burst
+	 */
+	PackedRadioBurst() : info(PUNCTURE_FLAG) {
+	}
+
+	/**
+	 * @brief	Get length of radio burst in bits
+	 *
+	 * @return	Length of radio burst in bits
 	 *
-	 * @param	burstIdx	Number of this radio burst in radio burst structure
 	 */
-	void addMidamble(const uint16_t burstIdx) {
-		if (burstIdx < TSUNB_RADIO_BURST_CORE_BURSTS) {
-			// Core Bursts
-			writeBit(0, 12 + HEAD_BITS, data);
-			writeBit(1, 13 + HEAD_BITS, data);
-			writeBit(1, 14 + HEAD_BITS, data);
-			writeBit(1, 15 + HEAD_BITS, data);
-
-			writeBit(0, 16 + HEAD_BITS, data);
-			writeBit(1, 17 + HEAD_BITS, data);
-			writeBit(0, 18 + HEAD_BITS, data);
-			writeBit(0, 19 + HEAD_BITS, data);
-
-			writeBit(0, 20 + HEAD_BITS, data);
-			writeBit(0, 21 + HEAD_BITS, data);
-			writeBit(1, 22 + HEAD_BITS, data);
-			writeBit(0, 23 + HEAD_BITS, data);
-		}
-		else {
-			// Extension Bursts
-			writeBit(0, 12 + HEAD_BITS, data);
-			writeBit(1, 13 + HEAD_BITS, data);
-			writeBit(0, 14 + HEAD_BITS, data);
-			writeBit(0, 15 + HEAD_BITS, data);
+	uint16_t getBurstLength(void) const {
+		if (info & PUNCTURE_FLAG)
+			return 0;
+		else
+			return Base::BURST_LENGTH;
+	}
 
-			writeBit(1, 16 + HEAD_BITS, data);
-			writeBit(1, 17 + HEAD_BITS, data);
-			writeBit(1, 18 + HEAD_BITS, data);
-			writeBit(1, 19 + HEAD_BITS, data);
+	/**
+	 * @brief	Get byte length of radio burst
+	 *
+	 * @return	Length of radio burst in bytes
+	 *
+	 */
+	uint16_t getBurstLengthBytes(void) const {
+		if (info & PUNCTURE_FLAG)
+			return 0;
+		else
+			return Base::BURST_LENGTH_BYTES;
+	}
 
-			writeBit(1, 20 + HEAD_BITS, data);
-			writeBit(0, 21 + HEAD_BITS, data);
-			writeBit(1, 22 + HEAD_BITS, data);
-			writeBit(0, 23 + HEAD_BITS, data);
-		}		
+	/**
+	 * @brief	Set value T_RB
+	 *
+	 * Set the value T_RB. T_RB is the time between the start of this radio burst and
+	 * the start of the following radio burst in multiples of symbols.
+	 *
+	 * @param	t		Time T_RB, at most MAX_T_RB
+	 *
+	 */
+	void set_T_RB(const uint16_t t) {
+		info = (info & ~T_RB_MASK) | (t << T_RB_SHIFT);
 	}
 
 	/**
-	 * @brief	Differential encoding
+	 * @brief	Get the value T_RB
 	 *
-	 * This method does the differential encoding. It
-	 * has to be called after adding the midamble.
+	 * Get the value T_RB. T_RB is the time between the start of this radio burst and
+	 * the start of the following radio burst in multiples of symbols.
+	 *
+	 * @return	Time T_RB
 	 *
 	 */
-	void differentialMSKEncoding() {
-		uint8_t shiftedData = 0;
-		uint8_t firstBitLastByte = 0;
-		for(uint16_t s = 0; s < BURST_LENGTH_BYTES; ++s) {
-			shiftedData = firstBitLastByte | (data[s] >> 1);
-			firstBitLastByte = data[s] << 7;
-			data[s] ^= shiftedData;
-		}
-		// The first and last two bits of each burst are don't cares
-		// Setting at least one initial bit to 1 is a workaround
-		if (HEAD_BITS > 0)
-			data[0] |= 0x80;
+	uint16_t get_T_RB() const {
+		return info >> T_RB_SHIFT;
+	}
+
+	/**
+	 * @brief	Set the carrier offset
+	 *
+	 * This method sets the carrier offset between the frequency f_0 and
+	 * the radio burst frequency in transmitter register values. The offset
+	 * has to be a multiple of B_c.
+	 *
+	 * @param	offset		Frequency offset wrt. f_0 in TX register values
+	 *
+	 */
+	void setCarrierOffset(const uint16_t offset) {
+		setCarrier((uint8_t) (offset / B_c));
+	}
+
+	/**
+	 * @brief	Get the carrier offset for the radio burst
+	 *
+	 * This method return the carrier offset between the frequency f_0 and
+	 * the radio burst frequency in transmitter register values.
+	 *
+	 * @return	Frequency offset wrt. f_0 in TX register values, 0xFFFF if the burst is punctured
+	 *
+	 */
+	uint16_t getCarrierOffset(void) const {
+		if (info & PUNCTURE_FLAG)
+			return 0xFFFF;
+		else
+			return (uint16_t) (info & CARRIER_MASK) * B_c;
+	}
+
+	/**
+	 * @brief	Set the carrier index
+	 *
+	 * @param	carrier		Carrier index C_RB, i.e. the carrier offset in multiples of B_c
+	 *
+	 */
+	void setCarrier(const uint8_t carrier) {
+		info = (info & T_RB_MASK) | (carrier & CARRIER_MASK);
+	}
 
+	/**
+	 * @brief	Get the carrier index
+	 *
+	 * @return	Carrier index C_RB, i.e. the carrier offset in multiples of B_c
+	 *
+	 */
+	uint8_t getCarrier(void) const {
+		return (uint8_t) (info & CARRIER_MASK);
 	}
 
 	/**
 	 * @brief	Puncture burst, i.e. it is not transmitted
 	 */
 	void puncture() {
-		carrierOffset = 0xFFFF;	
+		info |= PUNCTURE_FLAG;
 	}
 
 private:
-	//! Storage for radio burst data
-	uint8_t data[BURST_LENGTH_BYTES];
+	//! Bits of the carrier index in info
+	static const uint16_t CARRIER_MASK = 0x001F;
 
-	//! Offset in transmitter register values relative to the system frequency f_0
-	uint16_t carrierOffset;
+	//! Puncture flag in info
+	static const uint16_t PUNCTURE_FLAG = 0x0020;
+
+	//! Position of T_RB in info
+	static const uint16_t T_RB_SHIFT = 6;
+
+	//! Bits of T_RB in info
+	static const uint16_t T_RB_MASK = MAX_T_RB << T_RB_SHIFT;
+
+	//! Carrier index (bits 0...4), puncture flag (bit 5) and T_RB (bits 6...15)
+	uint16_t info;
+};
 
-	//! Delay between start time of two radio burst, also internally used for number of written bits calculation in symbol durations
-	uint16_t T_RB;
 
+/**
+ * @brief	Source of radio bursts for an array of already encoded radio bursts
+ *
+ * Transmitters read the radio bursts one after another using the method
+ * getNextRadioBurst(). This class offers this interface for an array of radio bursts,
+ * e.g. generated by the encode() method of the PHY.
+ *
+ * The template parameter RadioBurst_T defines the radio burst class.
+ *
+ */
+template<class RadioBurst_T>
+class RadioBurstArray {
+public:
 	/**
-	 * @brief Function to calculate the sub-packet index for the data interleaving
+	 * @brief Constructor
 	 *
-	 * @param	burstIdx	Index of the radio burst
-	 * @param	bitIdx		Index of the bit within the burst
+	 * @param	RadioBursts_	Pointer to the radio bursts
+	 * @param	numBursts_		Number of radio bursts
+	 */
+	RadioBurstArray(const RadioBurst_T* const RadioBursts_, const uint16_t numBursts_) :
+		RadioBursts(RadioBursts_), numBursts(numBursts_), burstIdx(0) {
+	}
+
+	/**
+	 * @brief	Get the next radio burst
 	 *
-	 * @return	Position of the bit within the data[] array
+	 * @param	RadioBurst	Pointer to the radio burst for the output
+	 *
+	 * @return	True if a radio burst was returned, false if all radio bursts have already been returned
 	 */
-	uint16_t getSubPkgBitIdx(const uint16_t burstIdx, const uint8_t bitIdx) const {
-		if((burstIdx ^ bitIdx) & 1) 		// (pkt even & bit odd) | (pkt odd & bit even)
-			return 24 + (bitIdx >> 1);		// 24 offset
-		else								// (pkt odd & bit odd) | (pkt even & bit even)
-			return 11 - (bitIdx >> 1);		// 11  offset
+	bool getNextRadioBurst(RadioBurst_T* const RadioBurst) {
+		if (burstIdx >= numBursts)
+			return false;
+
+		*RadioBurst = RadioBursts[burstIdx++];
+		return true;
 	}
 
+private:
+	//! Pointer to the radio bursts
+	const RadioBurst_T* const RadioBursts;
+
+	//! Number of radio bursts
+	const uint16_t numBursts;
 
+	//! Index of the next radio burst
+	uint16_t burstIdx;
 };
 
 };	// namespace TsUnb
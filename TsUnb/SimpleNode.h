@@ -85,10 +85,163 @@ ks-contracts@iis.fraunhofer.de
 
 #include <inttypes.h>
 
+/**
+ * @brief RAM budget of a SimpleNode instance in bytes
+ *
+ * The build fails if a node including its buffers exceeds this budget. The platform
+ * can set a smaller value, e.g. depending on the RAM of the MCU.
+ */
+#ifndef TSUNB_NODE_RAM_BUDGET
+#define TSUNB_NODE_RAM_BUDGET	65535
+#endif
+
 namespace TsUnbLib {
 namespace TsUnb {
 
 
+/**
+ * @brief Sync burst handling of the SimpleNode
+ *
+ * This template class caches the sync bursts of all TSMA patterns and transmits the sync burst of
+ * the used TSMA pattern in front of the data bursts. The specialization for SYNC_BURST == false
+ * transmits the data bursts only and does not contain any data, i.e. it does not need any RAM
+ * as base class of the SimpleNode.
+ */
+template<typename PHY, bool SYNC_BURST>
+class SimpleNodeSyncBurst {
+public:
+	SimpleNodeSyncBurst() : syncBurstsValid(false), syncBurstAddress(0) {
+	}
+
+	/**
+	 * @brief Generates the sync bursts of all TSMA patterns for the short address
+	 *
+	 * @param	lsbShortAddress	LSB of the short address
+	 */
+	void initSyncBursts(const uint8_t lsbShortAddress) {
+		PHY Phy;
+
+		syncBurstAddress = lsbShortAddress;
+		for (uint8_t i = 0; i < TSUNBPHY_UNB_NUM_P; ++i)
+			Phy.encodeSyncBurst(&SyncBursts[i], i, syncBurstAddress);
+		syncBurstsValid = true;
+	}
+
+	/**
+	 * @brief Blocking transmission of the sync burst followed by the data bursts of the PHY
+	 *
+	 * @param	Tx				Transmitter
+	 * @param	Phy				PHY with the started streaming encoder
+	 * @param	freqReg			Frequency register setting of the transmitter
+	 * @param	tsmaPattern		Used TSMA pattern
+	 * @param	lsbShortAddress	LSB of the short address
+	 *
+	 * @return	Return value of the transmitter
+	 */
+	template<typename TX>
+	int16_t transmitBursts(TX& Tx, PHY& Phy, const uint32_t freqReg, const uint8_t tsmaPattern, const uint8_t lsbShortAddress) {
+		SyncBurstSource Source(Phy, getSyncBurst(tsmaPattern, lsbShortAddress));
+		return Tx.transmit(Source, freqReg);
+	}
+
+	/**
+	 * @brief Non-blocking transmission of the sync burst followed by the data bursts of the PHY, see transmitBursts()
+	 */
+	template<typename TX>
+	int16_t beginTransmitBursts(TX& Tx, PHY& Phy, const uint32_t freqReg, const uint8_t tsmaPattern, const uint8_t lsbShortAddress) {
+		TxSource = SyncBurstSource(Phy, getSyncBurst(tsmaPattern, lsbShortAddress));
+		return Tx.beginTransmit(TxSource, freqReg);
+	}
+
+private:
+	/**
+	 * @brief Returns the sync burst of a TSMA pattern
+	 *
+	 * The sync bursts only depend on the short address, they are regenerated if it has changed.
+	 */
+	const typename PHY::RadioBurst_t& getSyncBurst(const uint8_t tsmaPattern, const uint8_t lsbShortAddress) {
+		if (!syncBurstsValid || syncBurstAddress != lsbShortAddress)
+			initSyncBursts(lsbShortAddress);
+
+		return SyncBursts[tsmaPattern % TSUNBPHY_UNB_NUM_P];
+	}
+
+	/**
+	 * @brief Source of the radio bursts in case of a sync burst
+	 *
+	 * This class returns the sync burst followed by the radio bursts of the streaming PHY encoder.
+	 */
+	class SyncBurstSource {
+	public:
+		SyncBurstSource() : SyncBurst(0), Phy(0), syncBurstSent(false) {
+		}
+
+		SyncBurstSource(PHY& Phy_, const typename PHY::RadioBurst_t& SyncBurst_) :
+				SyncBurst(&SyncBurst_), Phy(&Phy_), syncBurstSent(false) {
+		}
+
+		/**
+		 * @brief	Get the next radio burst
+		 *
+		 * @param	RadioBurst	Pointer to the radio burst for the output
+		 *
+		 * @return	True if a radio burst was returned, false if all radio bursts have already been returned
+		 */
+		bool getNextRadioBurst(typename PHY::RadioBurst_t* const RadioBurst) {
+			if (!syncBurstSent) {
+				*RadioBurst = *SyncBurst;
+				syncBurstSent = true;
+				return true;
+			}
+			return Phy->getNextRadioBurst(RadioBurst);
+		}
+
+	private:
+		//! The sync burst
+		const typename PHY::RadioBurst_t* SyncBurst;
+
+		//! PHY with the streaming encoder for the data bursts
+		PHY* Phy;
+
+		//! Flag if the sync burst has already been returned
+		bool syncBurstSent;
+	};
+
+	//! Cached sync bursts, indexed by the TSMA pattern
+	typename PHY::RadioBurst_t SyncBursts[TSUNBPHY_UNB_NUM_P];
+
+	//! Flag if the cached sync bursts are valid
+	bool syncBurstsValid;
+
+	//! Short address LSB of the cached sync bursts
+	uint8_t syncBurstAddress;
+
+	//! Burst source of the non-blocking transmission
+	SyncBurstSource TxSource;
+};
+
+
+/**
+ * @brief Specialization of SimpleNodeSyncBurst without sync burst
+ */
+template<typename PHY>
+class SimpleNodeSyncBurst<PHY, false> {
+public:
+	void initSyncBursts(const uint8_t) {
+	}
+
+	template<typename TX>
+	int16_t transmitBursts(TX& Tx, PHY& Phy, const uint32_t freqReg, const uint8_t, const uint8_t) {
+		return Tx.transmit(Phy, freqReg);
+	}
+
+	template<typename TX>
+	int16_t beginTransmitBursts(TX& Tx, PHY& Phy, const uint32_t freqReg, const uint8_t, const uint8_t) {
+		return Tx.beginTransmit(Phy, freqReg);
+	}
+};
+
+
 /**
  * @brief Template class for the generation and transmission of simple TS-UNB uplink-only data
  *
@@ -99,24 +252,49 @@ namespace TsUnb {
  *
  * The template parameter MAC defines a class for the MAC encoding. This class has to offer an int16_t init() method,
  * a uin16_t MPDU_Length(payloadLength) to get the length of the MPDU data as function of the payload length,
+ * a static constexpr uint16_t maxMPDU_Length(payloadLength) for the maximum MPDU length at compile time,
  * and a uin16_t encode(MPDU, payload, payloadLength) method for the encoding where the return value is the length of the MPDU.
  *
- * The template parameter PHY defines a class for the PHY encoding. This class has to offer a
+ * The template parameter PHY defines a class for the PHY encoding. This class has to offer a static constexpr
  * uint16_t numRadioBursts(MPDU_length) method to return the number of radio bursts as function of the MPDU length.
- * In addition, it has to offer a uint32_t encode(RadioBurst_T* const RadioBursts, const uint8_t* const MPDU, const uint16_t MPDU_Length,
- * const uint8_t TSMAPattern) method for generating the data bursts. The return value is the frequency register setting of the
- * transmitter, or 0 in case of an error.
+ * In addition, it has to offer a uint32_t beginEncodeInPlace(uint8_t* const PhyPayload, const uint16_t MPDU_Length,
+ * const uint8_t TSMAPattern, const uint8_t MMODE) method for starting the encoding of the MPDU, which the MAC has written to the PHY payload
+ * at TSUNBPHY_PAYLOAD_DATA_POS. The return value is the frequency register setting of the
+ * transmitter, or 0 in case of an error. The data bursts are then generated on demand using the method
+ * bool getNextRadioBurst(RadioBurst_T* const RadioBurst).
  *
+ * The template parameter TX defines a class for the transmission. This class has to offer an int16_t init() method
+ * and a int16_t transmit(BurstSource_T& Source, const uint32_t frequency) method, which reads the radio bursts
+ * from the source one after another. For the non-blocking methods beginSend(), poll() and cancel() it has to offer
+ * the methods int16_t beginTransmit(BurstSource_T& Source, const uint32_t frequency), bool isTransmitting() and
+ * void cancelTransmit(), e.g. using an interrupt driven transmission.
+ *
+ * All buffers are sized at compile time for the maximum payload length MAX_PAYLOAD, which defaults to the
+ * largest payload the PHY supports. If STATIC_BUFFER is set, the PHY payload and the PHY encoder are members
+ * of the node, i.e. they are placed in static memory for a global node, and they are shared by send() and
+ * the non-blocking methods. Otherwise, send() allocates them on the stack and the non-blocking methods are
+ * not available. The build fails if the node exceeds TSUNB_NODE_RAM_BUDGET.
  *
  */
-template<typename MAC, typename PHY, typename TX, bool SYNC_BURST = false>
-class SimpleNode {
+template<typename MAC, typename PHY, typename TX, bool SYNC_BURST = false,
+		uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - MAC::maxMPDU_Length(0), bool STATIC_BUFFER = true>
+class SimpleNode : private SimpleNodeSyncBurst<PHY, SYNC_BURST> {
 public:
 
+	//! Maximum MPDU length for MAX_PAYLOAD
+	static constexpr uint16_t MAX_MPDU_LENGTH = MAC::maxMPDU_Length(MAX_PAYLOAD);
+
+	//! Length of the PHY payload buffer for MAX_PAYLOAD
+	static constexpr uint16_t PHY_PAYLOAD_LENGTH = PHY::numRadioBursts(MAX_MPDU_LENGTH);
+
+	static_assert(MAX_MPDU_LENGTH <= TSUNBPHY_MAX_PSDU_LENGTH, "MAX_PAYLOAD exceeds the maximum PSDU length");
+
 	/**
-	 * @brief Constructor, currently not used
+	 * @brief Constructor
 	 */
-	SimpleNode() {
+	SimpleNode() : sendActive(false) {
+		static_assert(sizeof(*this) + (STATIC_BUFFER ? 0 : PHY_PAYLOAD_LENGTH + sizeof(PHY)) <= TSUNB_NODE_RAM_BUDGET,
+				"SimpleNode exceeds TSUNB_NODE_RAM_BUDGET, reduce MAX_PAYLOAD");
 	}
 
 	/**
@@ -141,6 +319,12 @@ public:
 			return ret;
 
 		ret = Mac.init();
+		if (ret < 0)
+			return ret;
+
+		if (SYNC_BURST)
+			this->initSyncBursts(Mac.getLsbShortAddress());
+
 		return ret;
 	}
 
@@ -149,74 +333,95 @@ public:
 	 *
 	 * This method transmit the requested payload data. It does the MAC and PHY
 	 * encoding as well as the transmission of the data using the transmitter.
+	 * It fails while a non-blocking transmission is pending.
 	 *
 	 * @param	payload			Pointer to payload data
-	 * @param payloadLength	Length of the payload data in bytes
+	 * @param payloadLength	Length of the payload data in bytes, at most MAX_PAYLOAD
 	 * @param priotry  Uses low prioty uplink pattern if set 6
 	 *
 	 * @return	Non-negative number in case of success, negative number in case of error
 	 */
 	int16_t send(const uint8_t* const payload, const uint16_t payloadLength, 
 			const uint8_t MPF_value = 0, const bool priority = false) {
+		if (STATIC_BUFFER) {
+			if (Tx.isTransmitting())
+				return -2;
+			sendActive = false;
 
-		//! MPF field is present if MPF_value != 0
-		const bool MPF_present = MPF_value != 0;
-
-		uint16_t MPDU_length = Mac.MPDU_Length(payloadLength, MPF_present);
-
-		if (MPDU_length == 0)
-			return -1;
-
-		uint8_t MPDU[MPDU_length];
-		Mac.encode(MPDU, payload, payloadLength, MPF_present, MPF_value);
+			return transmit(TxPhy, TxPhyPayload, payload, payloadLength, MPF_value, priority);
+		}
 
 		//! PHY Instance.
 		PHY Phy;
 
-		uint16_t numRadioBursts = Phy.numRadioBursts(MPDU_length);
-		if (SYNC_BURST == true)
-			numRadioBursts++;
+		//! PHY payload, the radio bursts are generated on demand during the transmission
+		uint8_t PhyPayload[STATIC_BUFFER ? 1 : PHY_PAYLOAD_LENGTH];
 
-		//! Allocate memory for storing radio bursts
-		typename PHY::RadioBurst_t Bursts[numRadioBursts];
+		return transmit(Phy, PhyPayload, payload, payloadLength, MPF_value, priority);
+	}
 
-		// Transmit frequency
-		uint32_t freqReg;
-
-		// We have to do a seperate handling if the Sync Burts is used
-		if (SYNC_BURST == false) {
-			// Normal mode without sync burst
-			if (priority)
-				freqReg = Phy.encode(Bursts, MPDU, MPDU_length, 6, MAC::MMODE);
-			else
-				freqReg = Phy.encode(Bursts, MPDU, MPDU_length, Phy.getTsmaPattern(Mac.getCounter()), MAC::MMODE);
-
-			if (freqReg > 0)
-				return Tx.transmit(Bursts, numRadioBursts, freqReg);
-			else
-				return -1;
-		}
-		else {
-			// This is special handling in caes of a sync burst
-			numRadioBursts += 1;
-			
-			// The first data Burst is Burst[1] as Burst[0] is the Sync Burst
-			if (priority) {
-				freqReg = Phy.encode(&Bursts[1], MPDU, MPDU_length, 6, MAC::MMODE);
-				Phy.encodeSyncBurst(&Bursts[0], 6, Mac.getLsbShortAddress());
-			}
-			else {
-				const uint8_t tsmaPattern = Phy.getTsmaPattern(Mac.getCounter());
-				freqReg = Phy.encode(&Bursts[1], MPDU, MPDU_length, tsmaPattern, MAC::MMODE);
-				Phy.encodeSyncBurst(&Bursts[0], tsmaPattern, Mac.getLsbShortAddress());
-			}
+	/**
+	 * @brief Starts the non-blocking transmission of a TS-UNB packet
+	 *
+	 * This method does the MAC and PHY encoding like send() and starts the transmission, but it
+	 * returns before the first radio burst. The transmission is then performed by the transmitter,
+	 * e.g. within the timer interrupt, and the radio bursts are generated on demand from the PHY
+	 * payload stored in the node. The progress can be checked using poll().
+	 * It requires STATIC_BUFFER.
+	 *
+	 * @param	payload			Pointer to payload data, which is not required after the return
+	 * @param	payloadLength	Length of the payload data in bytes, at most MAX_PAYLOAD
+	 * @param	MPF_value		Value of the MPF field, the field is present if not 0
+	 * @param	priority		Uses the low latency uplink pattern if set
+	 *
+	 * @return	0 in case of success, -1 in case of an encoding error, -2 if a transmission is still active
+	 */
+	int16_t beginSend(const uint8_t* const payload, const uint16_t payloadLength,
+			const uint8_t MPF_value = 0, const bool priority = false) {
+		static_assert(STATIC_BUFFER, "The non-blocking transmission requires STATIC_BUFFER");
 
-		}
-		if (freqReg > 0)
-			return Tx.transmit(Bursts, numRadioBursts, freqReg);
-		else
+		if (Tx.isTransmitting())
+			return -2;
+		sendActive = false;
+
+		uint8_t tsmaPattern;
+		const uint32_t freqReg = encode(TxPhy, TxPhyPayload, payload, payloadLength, MPF_value, priority, tsmaPattern);
+		if (freqReg == 0)
 			return -1;
 
+		const int16_t ret = this->beginTransmitBursts(Tx, TxPhy, freqReg, tsmaPattern, Mac.getLsbShortAddress());
+		if (ret < 0)
+			return -2;
+
+		sendActive = true;
+		return 0;
+	}
+
+	/**
+	 * @brief Returns the state of the non-blocking transmission
+	 *
+	 * @return	1 while the transmission is pending, also while the current radio burst is completed
+	 * 			after cancel(), 0 if it has finished, -1 if no transmission has been started or it
+	 * 			has been cancelled
+	 */
+	int16_t poll() {
+		if (Tx.isTransmitting())
+			return 1;
+
+		return sendActive ? 0 : -1;
+	}
+
+	/**
+	 * @brief Aborts the non-blocking transmission
+	 *
+	 * The radio burst, which is currently transmitted, is completed, but the remaining radio bursts
+	 * are not transmitted. The transmitter is switched off at the next timer event, i.e. poll()
+	 * returns 1 until then.
+	 */
+	void cancel() {
+		if (sendActive)
+			Tx.cancelTransmit();
+		sendActive = false;
 	}
 
 	//! Instance of TX that is active during the complete lifetime of this class
@@ -225,6 +430,65 @@ public:
 	//! Instance of the MAC that is active during the complete lifetime of this class
 	MAC Mac;
 
+private:
+	/**
+	 * @brief Encoding and blocking transmission of a TS-UNB packet, see send()
+	 */
+	int16_t transmit(PHY& Phy, uint8_t* const PhyPayload, const uint8_t* const payload, const uint16_t payloadLength,
+			const uint8_t MPF_value, const bool priority) {
+		uint8_t tsmaPattern;
+		const uint32_t freqReg = encode(Phy, PhyPayload, payload, payloadLength, MPF_value, priority, tsmaPattern);
+		if (freqReg == 0)
+			return -1;
+
+		// The sync burst, if used, is transmitted before the data bursts
+		return this->transmitBursts(Tx, Phy, freqReg, tsmaPattern, Mac.getLsbShortAddress());
+	}
+
+	/**
+	 * @brief MAC encoding and start of the streaming PHY encoding
+	 *
+	 * @param	Phy				PHY instance for the streaming encoding
+	 * @param	PhyPayload		PHY payload with PHY_PAYLOAD_LENGTH bytes, must be valid during the transmission
+	 * @param	payload			Pointer to payload data
+	 * @param	payloadLength	Length of the payload data in bytes
+	 * @param	MPF_value		Value of the MPF field, the field is present if not 0
+	 * @param	priority		Uses the low latency uplink pattern if set
+	 * @param	tsmaPattern		Used TSMA pattern for the output
+	 *
+	 * @return	Frequency register setting of the transmitter, 0 in case of an error
+	 */
+	uint32_t encode(PHY& Phy, uint8_t* const PhyPayload, const uint8_t* const payload, const uint16_t payloadLength,
+			const uint8_t MPF_value, const bool priority, uint8_t& tsmaPattern) {
+		if (payloadLength > MAX_PAYLOAD)
+			return 0;
+
+		//! MPF field is present if MPF_value != 0
+		const bool MPF_present = MPF_value != 0;
+
+		const uint16_t MPDU_length = Mac.MPDU_Length(payloadLength, MPF_present);
+
+		// The MAC writes the MPDU directly into the PHY payload, which is then encoded in place
+		Mac.encode(&PhyPayload[TSUNBPHY_PAYLOAD_DATA_POS], payload, payloadLength, MPF_present, MPF_value);
+
+		// TSMA pattern
+		if (priority)
+			tsmaPattern = 6;
+		else
+			tsmaPattern = Phy.getTsmaPattern(Mac.getCounter());
+
+		// Transmit frequency
+		return Phy.beginEncodeInPlace(PhyPayload, MPDU_length, tsmaPattern, MAC::MMODE);
+	}
+
+	//! Flag if a non-blocking transmission has been started and not been cancelled
+	bool sendActive;
+
+	//! PHY payload of send() and the non-blocking transmission, only used with STATIC_BUFFER
+	uint8_t TxPhyPayload[STATIC_BUFFER ? PHY_PAYLOAD_LENGTH : 1];
+
+	//! PHY with the streaming encoder of send() and the non-blocking transmission, only used with STATIC_BUFFER
+	PHY TxPhy;
 
 };
 
@@ -0,0 +1,310 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+/**
+ * @brief	Interleaving of the radio bursts of several telegrams
+ *
+ * @file	TxScheduler.h
+ *
+ */
+
+
+#ifndef TSUNB_TX_SCHEDULER_H_
+#define TSUNB_TX_SCHEDULER_H_
+
+#include <stdint.h>
+
+#include "Phy.h"
+
+namespace TsUnbLib {
+namespace TsUnb {
+
+
+/**
+ * @brief Interleaving of the radio bursts of several telegrams into a single transmission schedule
+ *
+ * A radio burst occupies the transmitter for about 40 symbols, whereas the time T_RB between
+ * the radio bursts of a telegram is several hundred symbols. This class merges the radio bursts
+ * of several telegrams, e.g. of different sensor channels or addresses, into one timeline sorted
+ * by the start time, so that the bursts of one telegram are transmitted in the gaps of the
+ * others. Each telegram is shifted by a start offset in symbols and keeps its exact T_RB spacing.
+ * The start times are rounded to timer ticks identically to Phy::encodeSchedule().
+ *
+ * A telegram is only added if none of its radio bursts conflicts with an already scheduled
+ * burst, i.e. the start times of two consecutive bursts differ by at least the burst length
+ * plus GUARD_SYMBOLS. The guard has to cover the end of a burst and the wake up of the transmitter
+ * before the next burst, e.g. Rfm69hw::SCHEDULE_GUARD_SYMBOLS.
+ * Additionally, two consecutive bursts must not be more than 2^15 timer ticks apart and the
+ * first burst has to start within 2^15 timer ticks, since the transmitter uses 16 bit timer
+ * compare values. Zero length bursts are not scheduled.
+ *
+ * The merged radio bursts and the schedule can be transmitted using the transmit() method of the
+ * transmitter with a precalculated transmission schedule, e.g. Rfm69hw.
+ *
+ * @tparam	RadioBurst_T	Radio burst class
+ * @tparam	MAX_BURSTS		Maximum number of radio bursts of all telegrams
+ * @tparam	GUARD_SYMBOLS	Minimum time in symbols between the end of a burst and the start of the next burst
+ */
+template <class RadioBurst_T, uint16_t MAX_BURSTS, uint16_t GUARD_SYMBOLS>
+class TxScheduler {
+public:
+	/**
+	 * @brief Constructor
+	 *
+	 * @param	ticksPerSymbolQ16_	Duration of a symbol in timer ticks as Q16.16 fixed point value, e.g. Cpu_T::TS_UNB_BIT_DURATION_Q16
+	 */
+	TxScheduler(const uint32_t ticksPerSymbolQ16_) : ticksPerSymbolQ16(ticksPerSymbolQ16_) {
+		clear();
+	}
+
+	/**
+	 * @brief Removes all telegrams from the schedule
+	 */
+	void clear(void) {
+		numBursts = 0;
+	}
+
+	/**
+	 * @brief Adds the radio bursts of a telegram to the schedule
+	 *
+	 * The schedule remains unchanged in case of an error.
+	 *
+	 * @param	RadioBursts		Pointer to the encoded radio bursts of the telegram
+	 * @param	numTxBursts		Number of radio bursts
+	 * @param	frequency		Frequency f_0 of the radio bursts in register setting as returned by Phy::encode()
+	 * @param	offsetSymbols	Start time of the first radio burst in symbols relative to the start of the schedule
+	 *
+	 * @return	0 if OK, -1 if the schedule is full, -2 in case of a conflict with a scheduled burst
+	 */
+	int16_t addTelegram(const RadioBurst_T* const RadioBursts, const uint16_t numTxBursts,
+			const uint32_t frequency, const uint32_t offsetSymbols) {
+		const int16_t result = checkTelegram(RadioBursts, numTxBursts, offsetSymbols);
+		if (result != 0)
+			return result;
+
+		uint32_t startSymbol = offsetSymbols;
+		uint16_t pos = 0;
+		for (uint16_t burstIdx = 0; burstIdx < numTxBursts; ++burstIdx) {
+			const RadioBurst_T& Burst = RadioBursts[burstIdx];
+			if (Burst.getBurstLength() > 0) {
+				const uint32_t startTick = symbolsToTicks(startSymbol);
+				while (pos < numBursts && StartTicks[pos] < startTick)
+					++pos;
+
+				for (uint16_t i = numBursts; i > pos; --i) {
+					Bursts[i] = Bursts[i - 1];
+					Schedule[i] = Schedule[i - 1];
+					StartTicks[i] = StartTicks[i - 1];
+				}
+
+				const uint32_t freqReg = frequency + Burst.getCarrierOffset();
+				Bursts[pos] = Burst;
+				Schedule[pos].startTick = (uint16_t)startTick;
+				Schedule[pos].freqReg[0] = (uint8_t)(freqReg >> 16);
+				Schedule[pos].freqReg[1] = (uint8_t)(freqReg >> 8);
+				Schedule[pos].freqReg[2] = (uint8_t)freqReg;
+				StartTicks[pos] = startTick;
+				++numBursts;
+			}
+			startSymbol += Burst.get_T_RB();
+		}
+
+		return 0;
+	}
+
+	/**
+	 * @brief Checks if a telegram can be added to the schedule
+	 *
+	 * @param	RadioBursts		Pointer to the encoded radio bursts of the telegram
+	 * @param	numTxBursts		Number of radio bursts
+	 * @param	offsetSymbols	Start time of the first radio burst in symbols relative to the start of the schedule
+	 *
+	 * @return	0 if OK, -1 if the schedule is full, -2 in case of a conflict with a scheduled burst
+	 */
+	int16_t checkTelegram(const RadioBurst_T* const RadioBursts, const uint16_t numTxBursts,
+			const uint32_t offsetSymbols) const {
+		const uint32_t minDistance = symbolsToTicks(RadioBurst_T::BURST_LENGTH + GUARD_SYMBOLS);
+		uint16_t numNewBursts = 0;
+
+		// Merge the sorted start times of the telegram with the scheduled ones and check all neighbors
+		uint32_t startSymbol = offsetSymbols;
+		uint16_t pos = 0;
+		bool first = true;
+		uint32_t prevTick = 0;
+		for (uint16_t burstIdx = 0; burstIdx < numTxBursts; ++burstIdx) {
+			if (RadioBursts[burstIdx].getBurstLength() > 0) {
+				const uint32_t startTick = symbolsToTicks(startSymbol);
+				while (pos < numBursts && StartTicks[pos] < startTick) {
+					if (!first && !isValidDistance(prevTick, StartTicks[pos], minDistance))
+						return -2;
+					prevTick = StartTicks[pos++];
+					first = false;
+				}
+				if (first && startTick >= 0x8000u)
+					return -2;
+				if (!first && !isValidDistance(prevTick, startTick, minDistance))
+					return -2;
+				prevTick = startTick;
+				first = false;
+				++numNewBursts;
+			}
+			startSymbol += RadioBursts[burstIdx].get_T_RB();
+		}
+		if (pos < numBursts && !first && !isValidDistance(prevTick, StartTicks[pos], minDistance))
+			return -2;
+
+		if (numBursts + numNewBursts > MAX_BURSTS)
+			return -1;
+
+		return 0;
+	}
+
+	/**
+	 * @brief Searches the earliest start offset of a telegram without conflicts
+	 *
+	 * @param	RadioBursts		Pointer to the encoded radio bursts of the telegram
+	 * @param	numTxBursts		Number of radio bursts
+	 * @param	minOffset		Earliest start offset in symbols
+	 * @param	maxOffset		Latest start offset in symbols
+	 *
+	 * @return	Start offset in symbols or a negative value if no offset has been found
+	 */
+	int32_t findOffset(const RadioBurst_T* const RadioBursts, const uint16_t numTxBursts,
+			const uint32_t minOffset, const uint32_t maxOffset) const {
+		for (uint32_t offset = minOffset; offset <= maxOffset; ++offset) {
+			const int16_t result = checkTelegram(RadioBursts, numTxBursts, offset);
+			if (result == 0)
+				return (int32_t)offset;
+			if (result == -1)
+				return -1;
+		}
+		return -2;
+	}
+
+	/**
+	 * @brief Returns the number of scheduled radio bursts
+	 */
+	uint16_t getNumBursts(void) const {
+		return numBursts;
+	}
+
+	/**
+	 * @brief Returns the scheduled radio bursts sorted by their start time
+	 */
+	const RadioBurst_T* getBursts(void) const {
+		return Bursts;
+	}
+
+	/**
+	 * @brief Returns the transmission schedule with one entry per scheduled radio burst
+	 */
+	const TxScheduleEntry* getSchedule(void) const {
+		return Schedule;
+	}
+
+private:
+	/**
+	 * @brief Converts symbols into timer ticks rounded to the nearest tick
+	 */
+	uint32_t symbolsToTicks(const uint32_t symbols) const {
+		return (uint32_t)(((uint64_t)symbols * ticksPerSymbolQ16 + 0x8000u) >> 16);
+	}
+
+	/**
+	 * @brief Checks the distance between the start times of two consecutive radio bursts
+	 */
+	static bool isValidDistance(const uint32_t prevTick, const uint32_t tick, const uint32_t minDistance) {
+		return tick - prevTick >= minDistance && tick - prevTick < 0x8000u;
+	}
+
+	//! Duration of a symbol in timer ticks as Q16.16 fixed point value
+	uint32_t ticksPerSymbolQ16;
+
+	//! Number of scheduled radio bursts
+	uint16_t numBursts;
+
+	//! Scheduled radio bursts sorted by their start time
+	RadioBurst_T Bursts[MAX_BURSTS];
+
+	//! Transmission schedule of the scheduled radio bursts
+	TxScheduleEntry Schedule[MAX_BURSTS];
+
+	//! Start times of the scheduled radio bursts in timer ticks without wrap around
+	uint32_t StartTicks[MAX_BURSTS];
+};
+
+
+};	// namespace TsUnb
+};	// namespace TsUnbLib
+
+#endif	/* TSUNB_TX_SCHEDULER_H_ */
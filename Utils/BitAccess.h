@@ -127,6 +127,25 @@ static inline void writeBit(const uint8_t bit, const uint_fast16_t bitIdx, uint8
 	return;
 }
 
+/**
+ * @brief Transpose a 64 x 64 bit matrix
+ *
+ * The bit matrix is stored row by row with the first column in the MSB.
+ * After the transposition bit 63 - j of row i contains the former bit 63 - i of row j.
+ *
+ * @param matrix	Pointer to the 64 rows of the matrix
+ */
+static inline void transposeBits64(uint64_t* const matrix) {
+	uint64_t mask = 0x00000000FFFFFFFFull;
+	for (uint8_t j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+		for (uint8_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+			const uint64_t t = (matrix[k] ^ (matrix[k | j] >> j)) & mask;
+			matrix[k] ^= t;
+			matrix[k | j] ^= t << j;
+		}
+	}
+}
+
 };	// namespace TsUnbLib
 #endif // BIT_ACCESS_H_
 
@@ -0,0 +1,234 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+/**
+ * @brief	Comparison of the bit-sliced PHY encoder with the telegram encoder
+ *
+ * This host tool encodes random telegrams with Phy::encodeBitSliced() and with Phy::encode()
+ * and compares the results burst by burst, i.e. the frequency f_0, the burst data, the burst
+ * lengths, the carrier offsets and the times T_RB. All MPDU lengths, all TSMA patterns, both
+ * MAC modes and all three uplink pattern groups are tested with varying numbers of telegrams
+ * per call. Finally, the throughput of both encoders is reported.
+ *
+ * Build, e.g.:
+ *   g++ -std=c++11 -O3 -march=native -I../.. BitSlicedEncoder.cpp -o BitSlicedEncoder
+ *
+ * Usage:
+ *   BitSlicedEncoder [seed]
+ *
+ * The return value is 0 if both encoders produced identical radio bursts.
+ *
+ * @file	BitSlicedEncoder.cpp
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "TsUnb/RadioBurst.h"
+#include "TsUnb/Phy.h"
+
+using namespace TsUnbLib;
+
+//! Radio burst used for the test
+typedef TsUnb::RadioBurst<2, 2> RadioBurst_t;
+
+//! Minimum duration of the throughput measurement per encoder in seconds
+#define BITSLICED_MIN_DURATION		1.0
+
+
+/**
+ * @brief Compares the bit-sliced encoding of random telegrams with encode()
+ *
+ * @param	Random		Random number generator
+ * @param	numCalls	Number of calls of encodeBitSliced() to be updated
+ *
+ * @return	Number of telegrams with deviations
+ */
+template <class Phy_T>
+static uint32_t compareEncoders(std::mt19937& Random, uint32_t& numCalls) {
+	static const uint8_t numTelegramsPerCall[] = {1, 2, 37, TSUNBPHY_NUM_LANES};
+	Phy_T Phy;
+	uint32_t numErrors = 0;
+
+	for (uint16_t MPDU_Length = 0; MPDU_Length <= TSUNBPHY_MAX_PSDU_LENGTH; ++MPDU_Length) {
+		const uint16_t numBursts = Phy.numRadioBursts(MPDU_Length);
+		const uint8_t numTelegrams = numTelegramsPerCall[MPDU_Length % sizeof(numTelegramsPerCall)];
+		const uint8_t MMODE = (uint8_t)(MPDU_Length & 0x03);
+
+		std::vector<uint8_t> MPDUs(TSUNBPHY_NUM_LANES * (MPDU_Length + 1));
+		for (size_t i = 0; i < MPDUs.size(); ++i) {
+			MPDUs[i] = (uint8_t)Random();
+		}
+		std::vector<RadioBurst_t> Bursts(TSUNBPHY_NUM_LANES * numBursts);
+		std::vector<RadioBurst_t> Expected(numBursts);
+		RadioBurst_t* BurstPtrs[TSUNBPHY_NUM_LANES];
+		const uint8_t* MPDU_Ptrs[TSUNBPHY_NUM_LANES];
+		uint8_t TSMAPatterns[TSUNBPHY_NUM_LANES];
+		uint32_t freqRegs[TSUNBPHY_NUM_LANES];
+		for (uint8_t i = 0; i < TSUNBPHY_NUM_LANES; ++i) {
+			BurstPtrs[i] = &Bursts[i * numBursts];
+			MPDU_Ptrs[i] = &MPDUs[i * (MPDU_Length + 1)];
+			TSMAPatterns[i] = (uint8_t)((MPDU_Length + i) % TSUNBPHY_UNB_NUM_P);
+		}
+
+		++numCalls;
+		if (Phy.encodeBitSliced(BurstPtrs, freqRegs, MPDU_Ptrs, numTelegrams, MPDU_Length, TSMAPatterns, MMODE) != numTelegrams) {
+			numErrors += numTelegrams;
+			continue;
+		}
+
+		for (uint8_t i = 0; i < numTelegrams; ++i) {
+			const uint32_t freqReg = Phy.encode(&Expected[0], MPDU_Ptrs[i], MPDU_Length, TSMAPatterns[i], MMODE);
+			bool ok = freqRegs[i] == freqReg;
+			for (uint16_t b = 0; b < numBursts && ok; ++b) {
+				const RadioBurst_t& A = BurstPtrs[i][b];
+				const RadioBurst_t& E = Expected[b];
+				ok = A.getBurstLength() == E.getBurstLength() && A.getCarrierOffset() == E.getCarrierOffset()
+						&& A.get_T_RB() == E.get_T_RB()
+						&& memcmp(A.getBurst(), E.getBurst(), RadioBurst_t::BURST_LENGTH_BYTES) == 0;
+			}
+			if (!ok) {
+				printf("Deviation: MPDU length %u, telegram %u of %u, TSMA pattern %u, MMODE %u\n",
+						MPDU_Length, i, numTelegrams, TSMAPatterns[i], MMODE);
+				++numErrors;
+			}
+		}
+	}
+
+	return numErrors;
+}
+
+
+/**
+ * @brief Measures the throughput of both encoders in telegrams per second
+ */
+template <class Phy_T>
+static void measureThroughput(const uint16_t MPDU_Length) {
+	Phy_T Phy;
+	const uint16_t numBursts = Phy.numRadioBursts(MPDU_Length);
+	std::vector<uint8_t> MPDUs(TSUNBPHY_NUM_LANES * MPDU_Length + 1);
+	std::vector<RadioBurst_t> Bursts(TSUNBPHY_NUM_LANES * numBursts);
+	RadioBurst_t* BurstPtrs[TSUNBPHY_NUM_LANES];
+	const uint8_t* MPDU_Ptrs[TSUNBPHY_NUM_LANES];
+	uint8_t TSMAPatterns[TSUNBPHY_NUM_LANES];
+	uint32_t freqRegs[TSUNBPHY_NUM_LANES];
+	for (uint8_t i = 0; i < TSUNBPHY_NUM_LANES; ++i) {
+		BurstPtrs[i] = &Bursts[i * numBursts];
+		MPDU_Ptrs[i] = &MPDUs[i * MPDU_Length];
+		TSMAPatterns[i] = i % TSUNBPHY_UNB_NUM_P;
+	}
+
+	double rate[2];
+	for (uint8_t bitSliced = 0; bitSliced < 2; ++bitSliced) {
+		uint32_t numTelegrams = 0;
+		double duration = 0.0;
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		while (duration < BITSLICED_MIN_DURATION) {
+			if (bitSliced) {
+				Phy.encodeBitSliced(BurstPtrs, freqRegs, MPDU_Ptrs, TSUNBPHY_NUM_LANES, MPDU_Length, TSMAPatterns);
+			}
+			else {
+				for (uint8_t i = 0; i < TSUNBPHY_NUM_LANES; ++i) {
+					freqRegs[i] = Phy.encode(BurstPtrs[i], MPDU_Ptrs[i], MPDU_Length, TSMAPatterns[i]);
+				}
+			}
+			numTelegrams += TSUNBPHY_NUM_LANES;
+			duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+		rate[bitSliced] = numTelegrams / duration;
+	}
+
+	printf("MPDU length %u: encode() %.0f telegrams/s, encodeBitSliced() %.0f telegrams/s\n",
+			MPDU_Length, rate[0], rate[1]);
+}
+
+
+int main(int argc, char** argv) {
+	std::mt19937 Random(argc > 1 ? (uint32_t)atoi(argv[1]) : 1);
+	uint32_t numCalls = 0;
+
+	// EU1 for the uplink pattern groups 1 and 3, EU2 for the uplink pattern group 2
+	uint32_t numErrors = compareEncoders<TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG1, 3, RadioBurst_t> >(Random, numCalls);
+	numErrors += compareEncoders<TsUnb::Phy<14215168, 14202061, 468, 39, TsUnb::TsUnb_UPG2, 3, RadioBurst_t> >(Random, numCalls);
+	numErrors += compareEncoders<TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG3, 3, RadioBurst_t> >(Random, numCalls);
+	printf("Compared %u calls of encodeBitSliced() with encode(), %u deviations\n", numCalls, numErrors);
+
+	measureThroughput<TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG1, 3, RadioBurst_t> >(13);
+
+	return numErrors ? 1 : 0;
+}
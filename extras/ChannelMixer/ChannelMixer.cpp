@@ -0,0 +1,302 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+/**
+ * @brief	Generation of a wideband capture with the telegrams of many simulated nodes
+ *
+ * This host tool simulates a number of TS-UNB nodes, which transmit telegrams at random times.
+ * Each telegram is encoded with the FixedUplinkMac and the bit-sliced PHY encoder, which encodes
+ * up to 64 telegrams starting within the same block at once, modulated and mixed into one
+ * complex baseband capture centered between the channels A and B. Each node has its own random
+ * address and frequency offset, each telegram its own TSMA pattern and power. The capture is
+ * written as interleaved 32 bit float I/Q values, a list of all telegrams as CSV file.
+ *
+ * Build, e.g.:
+ *   g++ -std=c++11 -O3 -march=native -ffast-math -pthread -I../.. ChannelMixer.cpp -o ChannelMixer
+ *
+ * Usage:
+ *   ChannelMixer outputFile [numNodes [durationSeconds [meanIntervalSeconds [numThreads [samplesPerSymbol]]]]]
+ *
+ * @file	ChannelMixer.cpp
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TsUnb/RadioBurst.h"
+#include "TsUnb/FixedMac.h"
+#include "TsUnb/Phy.h"
+#include "Host/ChannelMixer.h"
+
+using namespace TsUnbLib;
+
+//! Radio burst used for the simulation
+typedef TsUnb::RadioBurst<2, 2> RadioBurst_t;
+
+//! Frequency of channel A as transmitter register setting (EU1)
+#define MIXER_CHAN_A			14224261
+
+//! Frequency of channel B as transmitter register setting (EU1)
+#define MIXER_CHAN_B			14222623
+
+//! Carrier spacing as transmitter register setting
+#define MIXER_B_C				39
+
+//! PHY used for the simulation
+typedef TsUnb::Phy<MIXER_CHAN_A, MIXER_CHAN_B, MIXER_B_C, MIXER_B_C, TsUnb::TsUnb_UPG1, 3, RadioBurst_t> Phy_t;
+
+//! Length of the MAC payload in bytes
+#define MIXER_PAYLOAD_LENGTH	10
+
+//! Maximum frequency offset of the nodes in Hz
+#define MIXER_MAX_FREQ_OFFSET	5000.0
+
+//! Power range of the telegrams in dB, the power is uniformly distributed between -MIXER_POWER_RANGE_DB and 0dB
+#define MIXER_POWER_RANGE_DB	20.0
+
+
+/**
+ * @brief Simulated node
+ */
+struct Node {
+	//! MAC of the node, containing the address, the key and the packet counter
+	TsUnb::FixedUplinkMac Mac;
+
+	//! Frequency offset of the node in Hz
+	double freqOffset;
+};
+
+/**
+ * @brief Start of the next telegram of a node
+ */
+struct NextTelegram {
+	//! Index of the first sample
+	uint64_t startSample;
+
+	//! Index of the node
+	uint32_t nodeIdx;
+
+	bool operator>(const NextTelegram& other) const {
+		return startSample > other.startSample;
+	}
+};
+
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s outputFile [numNodes [durationSeconds [meanIntervalSeconds [numThreads [samplesPerSymbol]]]]]\n", argv[0]);
+		return 1;
+	}
+
+	const uint32_t numNodes = argc > 2 ? (uint32_t)atoi(argv[2]) : 1000;
+	const double duration = argc > 3 ? atof(argv[3]) : 60.0;
+	const double meanInterval = argc > 4 ? atof(argv[4]) : 60.0;
+	const uint16_t numThreads = argc > 5 ? (uint16_t)atoi(argv[5]) : 0;
+	const uint16_t samplesPerSymbol = argc > 6 ? (uint16_t)atoi(argv[6]) : 96;
+
+	FILE* const File = fopen(argv[1], "wb");
+	FILE* const Log = fopen((std::string(argv[1]) + ".csv").c_str(), "w");
+	if (!File || !Log) {
+		fprintf(stderr, "Cannot open the output files\n");
+		return 1;
+	}
+	fprintf(Log, "startSample,node,counter,tsmaPattern,freqReg,freqOffset,powerDb\n");
+
+	Host::ChannelMixer<RadioBurst_t> Mixer(samplesPerSymbol, 1u << 18, numThreads);
+	Host::FileSink Sink(File);
+
+	const double sampleRate = Mixer.getSampleRate();
+	const uint64_t totalSamples = (uint64_t)(duration * sampleRate);
+	const uint32_t centerFreqReg = (MIXER_CHAN_A + MIXER_CHAN_B) / 2;
+
+	// Random parameters of the nodes
+	std::mt19937_64 Random(1);
+	std::uniform_int_distribution<uint32_t> RandomByte(0, 255);
+	std::uniform_real_distribution<double> RandomOffset(-MIXER_MAX_FREQ_OFFSET, MIXER_MAX_FREQ_OFFSET);
+	std::uniform_real_distribution<double> RandomPower(-MIXER_POWER_RANGE_DB, 0.0);
+	std::uniform_int_distribution<uint32_t> RandomPattern(0, TSUNBPHY_UNB_NUM_P - 1);
+	std::exponential_distribution<double> RandomInterval(1.0 / meanInterval);
+
+	std::vector<Node> Nodes(numNodes);
+	std::priority_queue<NextTelegram, std::vector<NextTelegram>, std::greater<NextTelegram> > Queue;
+	for (uint32_t i = 0; i < numNodes; ++i) {
+		uint8_t k[16];
+		for (uint8_t j = 0; j < 16; ++j) {
+			k[j] = (uint8_t)RandomByte(Random);
+		}
+		Nodes[i].Mac.init();
+		Nodes[i].Mac.setNetworkKey(k[0], k[1], k[2], k[3], k[4], k[5], k[6], k[7],
+				k[8], k[9], k[10], k[11], k[12], k[13], k[14], k[15]);
+		Nodes[i].Mac.setAddress(0x70, 0xB3, 0xD5, 0x67, 0x70, 0x00, (uint8_t)(i >> 8), (uint8_t)i);
+		Nodes[i].freqOffset = RandomOffset(Random);
+
+		const NextTelegram Next = {(uint64_t)(RandomInterval(Random) * sampleRate), i};
+		Queue.push(Next);
+	}
+
+	// All telegrams have the same MPDU length, so that up to TSUNBPHY_NUM_LANES of them are encoded at once
+	Phy_t Phy;
+	const uint16_t MPDU_Length = TsUnb::FixedUplinkMac().MPDU_Length(MIXER_PAYLOAD_LENGTH);
+	const uint16_t numBursts = Phy.numRadioBursts(MPDU_Length);
+	std::vector<uint8_t> MPDUs(TSUNBPHY_NUM_LANES * (size_t)MPDU_Length + 1);
+	std::vector<RadioBurst_t> Bursts(TSUNBPHY_NUM_LANES * (size_t)numBursts);
+	const uint8_t* MPDU_Ptrs[TSUNBPHY_NUM_LANES];
+	RadioBurst_t* BurstPtrs[TSUNBPHY_NUM_LANES];
+	for (uint8_t i = 0; i < TSUNBPHY_NUM_LANES; ++i) {
+		MPDU_Ptrs[i] = &MPDUs[i * (size_t)MPDU_Length];
+		BurstPtrs[i] = &Bursts[i * (size_t)numBursts];
+	}
+
+	uint32_t numTelegrams = 0;
+	uint32_t maxActive = 0;
+
+	while (Mixer.getPosition() < totalSamples) {
+		const uint64_t blockEnd = Mixer.getPosition() + Mixer.getBlockSamples();
+
+		// Encode all telegrams that start within the next block
+		while (!Queue.empty() && Queue.top().startSample < blockEnd && Queue.top().startSample < totalSamples) {
+			NextTelegram Batch[TSUNBPHY_NUM_LANES];
+			uint32_t counters[TSUNBPHY_NUM_LANES];
+			uint8_t tsmaPatterns[TSUNBPHY_NUM_LANES];
+			uint64_t startSamples[TSUNBPHY_NUM_LANES];
+			double freqOffsets[TSUNBPHY_NUM_LANES];
+			double powerDbs[TSUNBPHY_NUM_LANES];
+			float gains[TSUNBPHY_NUM_LANES];
+			uint32_t freqRegs[TSUNBPHY_NUM_LANES];
+
+			// A node is at most once in a batch, since its next telegram is queued after the encoding
+			uint8_t numBatch = 0;
+			while (numBatch < TSUNBPHY_NUM_LANES && !Queue.empty() && Queue.top().startSample < blockEnd
+					&& Queue.top().startSample < totalSamples) {
+				Batch[numBatch] = Queue.top();
+				Queue.pop();
+				Node& N = Nodes[Batch[numBatch].nodeIdx];
+
+				uint8_t payload[MIXER_PAYLOAD_LENGTH];
+				for (uint16_t j = 0; j < MIXER_PAYLOAD_LENGTH; ++j) {
+					payload[j] = (uint8_t)RandomByte(Random);
+				}
+
+				counters[numBatch] = N.Mac.getCounter();
+				N.Mac.encode(&MPDUs[numBatch * (size_t)MPDU_Length], payload, MIXER_PAYLOAD_LENGTH);
+
+				tsmaPatterns[numBatch] = (uint8_t)RandomPattern(Random);
+				startSamples[numBatch] = Batch[numBatch].startSample;
+				freqOffsets[numBatch] = N.freqOffset;
+				powerDbs[numBatch] = RandomPower(Random);
+				gains[numBatch] = (float)pow(10.0, powerDbs[numBatch] / 20.0);
+				++numBatch;
+			}
+
+			if (Mixer.addTelegrams(Phy, BurstPtrs, MPDU_Ptrs, numBatch, MPDU_Length, tsmaPatterns, TsUnb::FixedUplinkMac::MMODE,
+					startSamples, freqOffsets, gains, centerFreqReg, freqRegs) != numBatch) {
+				fprintf(stderr, "Encoding failed\n");
+				return 1;
+			}
+
+			for (uint8_t i = 0; i < numBatch; ++i) {
+				fprintf(Log, "%llu,%u,%u,%u,%u,%.1f,%.1f\n", (unsigned long long)startSamples[i], Batch[i].nodeIdx, counters[i],
+						tsmaPatterns[i], freqRegs[i], freqOffsets[i], powerDbs[i]);
+				++numTelegrams;
+
+				// The next telegram of the node starts after the end of this one
+				uint64_t telegramSamples = RadioBurst_t::BURST_LENGTH;
+				for (uint16_t j = 0; j + 1 < numBursts; ++j) {
+					telegramSamples += BurstPtrs[i][j].get_T_RB();
+				}
+				telegramSamples *= samplesPerSymbol;
+				const NextTelegram Following = {startSamples[i] + telegramSamples + (uint64_t)(RandomInterval(Random) * sampleRate), Batch[i].nodeIdx};
+				Queue.push(Following);
+			}
+		}
+
+		if (Mixer.getNumActiveTelegrams() > maxActive)
+			maxActive = Mixer.getNumActiveTelegrams();
+
+		Mixer.mixBlock(Sink);
+		fprintf(stderr, "\r%.1f s of %.1f s, %u telegrams", Mixer.getPosition() / sampleRate, duration, numTelegrams);
+	}
+
+	fprintf(stderr, "\nWrote %llu samples at %.3f samples/s, %u telegrams, at most %u simultaneously active\n",
+			(unsigned long long)Sink.numSamples, sampleRate, numTelegrams, maxActive);
+
+	fclose(Log);
+	fclose(File);
+	return 0;
+}
@@ -0,0 +1,254 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+
+/**
+ * @brief	Soak test of SimpleNode on a Linux host in real time
+ *
+ * This host tool transmits telegrams with SimpleNode using the Linux platform implementation,
+ * i.e. with the real TS-UNB symbol timing. By default the SPI transactions are passed to the
+ * RFM69 emulator, which checks the reconstructed bursts and their start times. Alternatively,
+ * a spidev device with an RFM69HW can be given. The tool reports the timing statistics of the
+ * timer events.
+ *
+ * Build, e.g.:
+ *   g++ -std=c++11 -O2 -I../.. LinuxNode.cpp -o LinuxNode
+ *
+ * If the tool is built with -DTSUNB_TIMING_AUDIT=16, the timing audit of each telegram is printed.
+ *
+ * Usage:
+ *   LinuxNode [numTelegrams [payloadLength [spidevDevice]]]
+ *
+ * The return value is 0 if the content and the frequencies of all bursts are correct. Timing
+ * violations, i.e. late timer events and bursts with a wrong length, are only reported, as
+ * they depend on the real-time capabilities of the host.
+ *
+ * @file	LinuxNode.cpp
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#include "TsUnb/RadioBurst.h"
+#include "TsUnb/FixedMac.h"
+#include "TsUnb/Phy.h"
+#include "TsUnb/SimpleNode.h"
+#include "Trx/Rfm69hw.h"
+#include "Host/LinuxCpu.h"
+
+using namespace TsUnbLib;
+
+//! Radio burst used for the test
+typedef TsUnb::RadioBurst<2, 2> RadioBurst_t;
+
+//! PHY used for the test (EU1)
+typedef TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG1, 3, RadioBurst_t> Phy_t;
+
+//! Symbol duration in nanoseconds
+#define LINUX_NODE_SYMBOL_NS	(1.0e9 / 2380.37109375)
+
+
+/**
+ * @brief Prints the timing statistics
+ */
+static void printStatistics(const Host::TimingStatistics& Stats) {
+	printf("timer events %u  missed %u  latency mean %.1fus max %.1fus\n", Stats.numEvents, Stats.numMissed,
+			Stats.getMeanLatencyNs() * 1.0e-3, Stats.maxLatencyNs * 1.0e-3);
+}
+
+
+/**
+ * @brief Prints the timing audit of the last telegram
+ */
+template <class Trx_T>
+static void printAudit(const Trx_T& Trx) {
+#ifdef TSUNB_TIMING_AUDIT
+	const double tickUs = 1.0e6 / 62500.0;
+	printf("audit: %u bursts  min slack %.0fus  max jitter %.0fus  drift %.0fus  max drift %.0fus\n",
+			Trx.Audit.numBursts, Trx.Audit.minSlack * tickUs, Trx.Audit.maxJitter * tickUs,
+			Trx.Audit.drift * tickUs, Trx.Audit.maxDrift * tickUs);
+#else
+	(void)Trx;
+#endif
+}
+
+
+/**
+ * @brief Transmits the telegrams to a spidev device
+ */
+static int runSpidev(const char* const device, const uint32_t numTelegrams, const uint16_t payloadLength) {
+	TsUnb::SimpleNode<TsUnb::FixedUplinkMac, Phy_t, Trx::Rfm69hw<Host::LinuxCpu<Host::SpidevSpi>, true, 10, RadioBurst_t> > Node;
+
+	if (Node.Tx.Cpu.Spi.openDevice(device) != 0) {
+		fprintf(stderr, "Cannot open %s\n", device);
+		return 1;
+	}
+	if (Node.init() != 0) {
+		fprintf(stderr, "No RFM69HW found\n");
+		return 1;
+	}
+	Node.Mac.setNetworkKey(0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c);
+	Node.Mac.setAddress(0x70, 0xB3, 0xD5, 0x67, 0x70, 0x00, 0x12, 0x34);
+
+	std::vector<uint8_t> payload(payloadLength + 1, 0);
+	for (uint32_t t = 0; t < numTelegrams; ++t) {
+		payload[0] = (uint8_t)t;
+		Node.send(payload.data(), payloadLength);
+		printAudit(Node.Tx);
+	}
+	printStatistics(Node.Tx.Cpu.getStatistics());
+
+	return Node.Tx.Cpu.Spi.numErrors ? 1 : 0;
+}
+
+
+/**
+ * @brief Transmits the telegrams to the RFM69 emulator and checks the bursts
+ */
+static int runEmulator(const uint32_t numTelegrams, const uint16_t payloadLength) {
+	TsUnb::SimpleNode<TsUnb::FixedUplinkMac, Phy_t, Trx::Rfm69hw<Host::LinuxCpu<Host::EmulatorSpi>, false, 10, RadioBurst_t> > Node;
+
+	if (Node.init() != 0) {
+		fprintf(stderr, "Emulator not found\n");
+		return 1;
+	}
+	Node.Mac.setNetworkKey(0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c);
+	Node.Mac.setAddress(0x70, 0xB3, 0xD5, 0x67, 0x70, 0x00, 0x12, 0x34);
+
+	Host::Rfm69Emulator& Emulator = Node.Tx.Cpu.Spi.Emulator;
+	Phy_t Phy;
+	uint32_t numErrors = 0;
+	uint32_t numLengthErrors = 0;
+	double maxStartError = 0.0;
+	std::vector<uint8_t> payload(payloadLength + 1, 0);
+
+	for (uint32_t t = 0; t < numTelegrams; ++t) {
+		payload[0] = (uint8_t)t;
+
+		// Expected bursts of the telegram
+		TsUnb::FixedUplinkMac RefMac = Node.Mac;
+		const uint16_t MPDU_length = RefMac.MPDU_Length(payloadLength);
+		std::vector<uint8_t> MPDU(MPDU_length);
+		RefMac.encode(MPDU.data(), payload.data(), payloadLength, false, 0);
+		std::vector<RadioBurst_t> Expected(Phy.numRadioBursts(MPDU_length));
+		const uint32_t freqReg = Phy.encode(Expected.data(), MPDU.data(), MPDU_length,
+				Phy.getTsmaPattern(RefMac.getCounter()), TsUnb::FixedUplinkMac::MMODE);
+
+		Emulator.Bursts.clear();
+		if (Node.send(payload.data(), payloadLength) != 0 || Emulator.Bursts.size() != Expected.size()) {
+			++numErrors;
+			continue;
+		}
+
+		double idealStart = 0.0;
+		for (size_t i = 0; i < Expected.size(); ++i) {
+			const Host::EmulatedBurst& E = Emulator.Bursts[i];
+			bool ok = E.frf == freqReg + Expected[i].getCarrierOffset();
+			for (uint16_t b = 0; b < RadioBurst_t::BURST_LENGTH && ok; ++b) {
+				ok = E.getBit(b) == ((Expected[i].getBurst()[b / 8] >> (7 - b % 8)) & 1);
+			}
+			if (!ok)
+				++numErrors;
+			if (E.numBits != RadioBurst_t::BURST_LENGTH)
+				++numLengthErrors;
+
+			const double startError = fabs((double)(E.startTime - Emulator.Bursts[0].startTime) - idealStart);
+			if (startError > maxStartError)
+				maxStartError = startError;
+			idealStart += Expected[i].get_T_RB() * LINUX_NODE_SYMBOL_NS;
+		}
+		printf("telegram %u: %u bursts, %.2fs\n", t, (unsigned)Expected.size(),
+				(Emulator.Bursts.back().endTime - Emulator.Bursts[0].startTime) * 1.0e-9);
+		printAudit(Node.Tx);
+	}
+	numErrors += Emulator.numFifoOverflows + Emulator.numFifoUnderruns + Node.Tx.Cpu.numTimerErrors;
+
+	printStatistics(Node.Tx.Cpu.getStatistics());
+	printf("errors %u  bursts with wrong length %u  max burst start error %.1fus\n", numErrors, numLengthErrors,
+			maxStartError * 1.0e-3);
+
+	return numErrors ? 1 : 0;
+}
+
+
+int main(int argc, char** argv) {
+	const uint32_t numTelegrams = argc > 1 ? (uint32_t)atoi(argv[1]) : 3;
+	const uint16_t payloadLength = argc > 2 ? (uint16_t)atoi(argv[2]) : 10;
+
+	if (argc > 3)
+		return runSpidev(argv[3], numTelegrams, payloadLength);
+	return runEmulator(numTelegrams, payloadLength);
+}
@@ -0,0 +1,169 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+/**
+ * @brief	Benchmark and file output of the host MSK modulator
+ *
+ * This host tool encodes a TS-UNB telegram, modulates it with the MskModulator and
+ * reports the throughput in samples per second. Optionally the samples of one telegram
+ * are written to a file as interleaved 32 bit float I/Q values.
+ *
+ * Build, e.g.:
+ *   g++ -std=c++11 -O3 -march=native -ffast-math -I../.. MskBenchmark.cpp -o MskBenchmark
+ *
+ * Usage:
+ *   MskBenchmark [samplesPerSymbol [gaussianBT [outputFile]]]
+ *
+ * The carrier offsets of a telegram span 24 * B_c transmitter steps, i.e. about 57kHz for the
+ * default B_c of 39. Therefore, samplesPerSymbol should be at least 32 to avoid aliasing.
+ *
+ * @file	MskBenchmark.cpp
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+#include "TsUnb/RadioBurst.h"
+#include "TsUnb/Phy.h"
+#include "Host/MskModulator.h"
+
+using namespace TsUnbLib;
+
+//! Radio burst used for the benchmark
+typedef TsUnb::RadioBurst<2, 2> RadioBurst_t;
+
+//! PHY used for the benchmark, EU1 settings
+typedef TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG1, 3, RadioBurst_t> Phy_t;
+
+//! Length of the MPDU in bytes
+#define BENCHMARK_MPDU_LENGTH		TSUNBPHY_MAX_PSDU_LENGTH
+
+//! Minimum duration of the benchmark in seconds
+#define BENCHMARK_MIN_DURATION		2.0
+
+
+int main(int argc, char** argv) {
+	const uint16_t samplesPerSymbol = argc > 1 ? (uint16_t)atoi(argv[1]) : 32;
+	const double gaussianBT = argc > 2 ? atof(argv[2]) : 0.0;
+
+	// Encode a telegram with random data
+	Phy_t Phy;
+	uint8_t MPDU[BENCHMARK_MPDU_LENGTH];
+	for (uint16_t i = 0; i < BENCHMARK_MPDU_LENGTH; ++i) {
+		MPDU[i] = (uint8_t)rand();
+	}
+	const uint16_t numBursts = Phy.numRadioBursts(BENCHMARK_MPDU_LENGTH);
+	std::vector<RadioBurst_t> Bursts(numBursts);
+	Phy.encode(&Bursts[0], MPDU, BENCHMARK_MPDU_LENGTH, 0, 0);
+
+	Host::MskModulator<RadioBurst_t> Modulator(samplesPerSymbol, gaussianBT);
+
+	// The frequency f_0 + 12 * B_c is the center of the telegram
+	const double centerOffset = -12.0 * 39 * TSUNB_HOST_FREQ_STEP;
+
+	if (argc > 3) {
+		FILE* const File = fopen(argv[3], "wb");
+		if (!File) {
+			fprintf(stderr, "Cannot open %s\n", argv[3]);
+			return 1;
+		}
+		Host::FileSink Sink(File);
+		Modulator.modulate(&Bursts[0], numBursts, Sink, centerOffset);
+		fclose(File);
+		printf("Wrote %llu samples at %.3f samples/s to %s\n", (unsigned long long)Sink.numSamples,
+				Modulator.getSampleRate(), argv[3]);
+	}
+
+	// Only the radio bursts are measured, the gaps do not require any computation
+	uint32_t numTelegrams = 0;
+	double duration = 0.0;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (duration < BENCHMARK_MIN_DURATION) {
+		for (uint16_t i = 0; i < numBursts; ++i) {
+			Modulator.modulateBurst(Bursts[i], centerOffset);
+		}
+		++numTelegrams;
+		duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	const double burstSamples = (double)numTelegrams * numBursts * Modulator.getBurstSamples();
+	const double telegramDuration = Modulator.getTelegramSamples(&Bursts[0], numBursts) / Modulator.getSampleRate();
+	printf("%u radio bursts, %u samples/symbol, BT %.2f: %.2f Msamples/s, %.0f x real time\n",
+			numBursts, samplesPerSymbol, gaussianBT, burstSamples / duration * 1e-6,
+			telegramDuration * numTelegrams / duration);
+
+	return 0;
+}
@@ -0,0 +1,225 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+
+
+/**
+ * @brief	Charge estimation of the power state policy between the radio bursts
+ *
+ * This host tool encodes one telegram per preset and estimates the charge of the RFM69HW and of
+ * the CPU during the telegram for three strategies:
+ * - fixed: wake up two symbols before each burst, sleep mode and plain idle mode in all gaps
+ *   (behavior without Rfm69PowerPolicy)
+ * - standby: like fixed, but the transmitter waits in standby mode
+ * - policy: decisions of Rfm69PowerPolicy, i.e. wake-up time, transmitter state and CPU low power wait
+ *
+ * The supply currents of the RFM69HW are taken from Rfm69PowerPolicy.h. The currents of the CPU
+ * are assumptions for an ATmega328p at 16MHz and 5V, see the defines below.
+ *
+ * Build, e.g.:
+ *   g++ -std=c++11 -O2 -I../.. PowerPolicy.cpp -o PowerPolicy
+ *
+ * Usage:
+ *   PowerPolicy [payloadLength]
+ *
+ * @file	PowerPolicy.cpp
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "TsUnb/RadioBurst.h"
+#include "TsUnb/FixedMac.h"
+#include "TsUnb/Phy.h"
+#include "Trx/Rfm69PowerPolicy.h"
+
+using namespace TsUnbLib;
+
+//! Radio burst used for the estimation
+typedef TsUnb::RadioBurst<2, 2> RadioBurst_t;
+
+//! Supply current of the RFM69HW in TX mode at 13dBm in nA (assumption)
+#define POWER_POLICY_IDD_TX_NA		45000000
+
+//! Supply current of the CPU in idle mode in nA (assumption)
+#define POWER_POLICY_CPU_IDLE_NA	3000000
+
+//! Supply current of the ADC, the analog comparator and the TWI in idle mode in nA (assumption)
+#define POWER_POLICY_CPU_GATED_NA	400000
+
+
+/**
+ * @brief Charge of a telegram in nC
+ */
+struct Charge {
+	double radio;
+	double cpu;
+
+	double getTotal() const {
+		return radio + cpu;
+	}
+};
+
+
+/**
+ * @brief Estimates the charge of one telegram for the three strategies and prints it
+ *
+ * @param	name			Name of the preset
+ * @param	payloadLength	Length of the MAC payload
+ */
+template <TsUnb::TsUnbUPGMode UPG, uint16_t SYMBOL_RATE_MULT>
+static void reportPreset(const char* const name, const uint16_t payloadLength) {
+	typedef TsUnb::Phy<14224261, 14222623, 39, 39, UPG, 3, RadioBurst_t> Phy_t;
+	typedef Trx::Rfm69PowerPolicy<SYMBOL_RATE_MULT> Policy_t;
+
+	TsUnb::FixedUplinkMac Mac;
+	Mac.setNetworkKey(0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c);
+	Mac.setAddress(0x70, 0xB3, 0xD5, 0x67, 0x70, 0x00, 0x12, 0x34);
+	std::vector<uint8_t> payload(payloadLength + 1, 0x55);
+	const uint16_t MPDU_length = Mac.MPDU_Length(payloadLength);
+	std::vector<uint8_t> MPDU(MPDU_length);
+	Mac.encode(MPDU.data(), payload.data(), payloadLength, false, 0);
+
+	Phy_t Phy;
+	std::vector<RadioBurst_t> Bursts(Phy.numRadioBursts(MPDU_length));
+	Phy.encode(Bursts.data(), MPDU.data(), MPDU_length, Phy.getTsmaPattern(Mac.getCounter()), TsUnb::FixedUplinkMac::MMODE);
+
+	const double symbolNs = Policy_t::SYMBOL_NS;
+	Charge Fixed = {0.0, 0.0};
+	Charge Standby = {0.0, 0.0};
+	Charge Policy = {0.0, 0.0};
+	uint32_t numBursts = 0;
+	uint32_t telegramSymbols = 0;
+
+	// Gap of the zero length bursts, which is added to the gap of the previous burst
+	uint16_t pendingSymbols = 0;
+	for (size_t i = 0; i < Bursts.size(); ++i) {
+		const uint16_t burstLength = Bursts[i].getBurstLength();
+		const uint16_t T_RB = Bursts[i].get_T_RB();
+		if (burstLength == 0) {
+			pendingSymbols += T_RB;
+			continue;
+		}
+		++numBursts;
+
+		// Transmission of the burst and the wake up before it
+		const double txCharge = burstLength * symbolNs * POWER_POLICY_IDD_TX_NA * 1.0e-9;
+		Fixed.radio += txCharge + Policy_t::getWakeCharge(2);
+		Standby.radio += txCharge + Policy_t::getWakeCharge(2);
+		Policy.radio += txCharge + Policy_t::getWakeCharge(Policy_t::WAKE_SYMBOLS);
+
+		// Gap to the wake up before the next burst, the last burst has none
+		if (i + 1 == Bursts.size())
+			break;
+		const uint16_t fixedGap = pendingSymbols + T_RB - burstLength - 2;
+		const uint16_t policyGap = pendingSymbols + T_RB - burstLength - Policy_t::WAKE_SYMBOLS;
+		pendingSymbols = 0;
+		Fixed.radio += Policy_t::getGapCharge(fixedGap, false);
+		Standby.radio += Policy_t::getGapCharge(fixedGap, true);
+		Policy.radio += Policy_t::getGapCharge(policyGap, Policy_t::useStandby(policyGap));
+		if (Policy_t::useCpuLowPower(policyGap))
+			Policy.cpu -= policyGap * symbolNs * POWER_POLICY_CPU_GATED_NA * 1.0e-9;
+		telegramSymbols += T_RB;
+	}
+	telegramSymbols += Bursts.back().getBurstLength();
+
+	// The CPU idles during the complete telegram
+	const double cpuIdle = telegramSymbols * symbolNs * POWER_POLICY_CPU_IDLE_NA * 1.0e-9;
+	Fixed.cpu += cpuIdle;
+	Standby.cpu += cpuIdle;
+	Policy.cpu += cpuIdle;
+
+	printf("%-14s %3u bursts %6.2fs  wake %u symbols  radio uC: fixed %7.1f standby %7.1f policy %7.1f"
+			"  CPU uC: fixed %7.1f policy %7.1f  saving %5.1fuC (%.1f%%)\n",
+			name, numBursts, telegramSymbols * symbolNs * 1.0e-9, Policy_t::WAKE_SYMBOLS,
+			Fixed.radio * 1.0e-3, Standby.radio * 1.0e-3, Policy.radio * 1.0e-3,
+			Fixed.cpu * 1.0e-3, Policy.cpu * 1.0e-3,
+			(Fixed.getTotal() - Policy.getTotal()) * 1.0e-3,
+			100.0 * (Fixed.getTotal() - Policy.getTotal()) / Fixed.getTotal());
+}
+
+
+int main(int argc, char** argv) {
+	const uint16_t payloadLength = argc > 1 ? (uint16_t)atoi(argv[1]) : 10;
+
+	reportPreset<TsUnb::TsUnb_UPG1, 48>("UPG1 2380sym/s", payloadLength);
+	reportPreset<TsUnb::TsUnb_UPG2, 48>("UPG2 2380sym/s", payloadLength);
+	reportPreset<TsUnb::TsUnb_UPG3, 48>("UPG3 2380sym/s", payloadLength);
+	reportPreset<TsUnb::TsUnb_UPG1, 8>("UPG1 397sym/s", payloadLength);
+	reportPreset<TsUnb::TsUnb_UPG2, 8>("UPG2 397sym/s", payloadLength);
+	reportPreset<TsUnb::TsUnb_UPG3, 8>("UPG3 397sym/s", payloadLength);
+
+	return 0;
+}
@@ -0,0 +1,660 @@
+/* -----------------------------------------------------------------------------
+
+Software License for the Fraunhofer TS-UNB-Lib
+
+(c) Copyright  2019 - 2023 Fraunhofer-Gesellschaft zur Förderung der angewandten
+Forschung e.V. All rights reserved.
+
+
+1. INTRODUCTION
+
+The Fraunhofer Telegram Splitting - Ultra Narrowband Library ("TS-UNB-Lib") is software
+that implements only the uplink of the ETSI TS 103 357 TS-UNB standard ("MIOTY") for wireless 
+data transmission in the field of IoT. Patent licenses for any patent claim regarding the 
+ETSI TS 103 357 TS-UNB standard implementation (including those of Fraunhofer) may be 
+obtained through Sisvel International S.A. 
+(https://www.sisvel.com/licensing-programs/wireless-communications/mioty/license-terms)
+or through the respective patent owners individually. The purpose of this TS-UNB-Lib is 
+academic and non-commercial use. Therefore, Fraunhofer does not offer any support for the 
+TS-UNB-Lib. Furthermore, the TS-UNB-Lib is NOT identical and on the same quality level as 
+the commercially-licensed MIOTY software also available from Fraunhofer. Users are encouraged
+to check the Fraunhofer website for additional applications information and documentation.
+
+
+2. COPYRIGHT LICENSE
+
+Redistribution and use in source and binary forms, with or without modification, are 
+permitted without payment of copyright license fees provided that you satisfy the following 
+conditions: You must retain the complete text of this software license in redistributions
+of the TS-UNB-Lib software or your modifications thereto in source code form. You must retain 
+the complete text of this software license in the documentation and/or other materials provided
+with redistributions of the TS-UNB-Lib software or your modifications thereto in binary form.
+You must make available free of charge copies of the complete source code of the TS-UNB-Lib 
+software and your modifications thereto to recipients of copies in binary form. The name of 
+Fraunhofer may not be used to endorse or promote products derived from this software without
+prior written permission. You may not charge copyright license fees for anyone to use, copy or
+distribute the TS-UNB-Lib software or your modifications thereto. Your modified versions of the
+TS-UNB-Lib software must carry prominent notices stating that you changed the software and the
+date of any change. For modified versions of the TS-UNB-Lib software, the term 
+"Fraunhofer TS-UNB-Lib" must be replaced by the term
+"Third-Party Modified Version of the Fraunhofer TS-UNB-Lib."
+
+
+3. NO PATENT LICENSE
+
+NO EXPRESS OR IMPLIED LICENSES TO ANY PATENT CLAIMS, including without limitation the patents 
+of Fraunhofer, ARE GRANTED BY THIS SOFTWARE LICENSE. Fraunhofer provides no warranty of patent 
+non-infringement with respect to this software. You may use this TS-UNB-Lib software or modifications
+thereto only for purposes that are authorized by appropriate patent licenses.
+
+
+4. DISCLAIMER
+
+This TS-UNB-Lib software is provided by Fraunhofer on behalf of the copyright holders and contributors
+"AS IS" and WITHOUT ANY EXPRESS OR IMPLIED WARRANTIES, including but not limited to the implied warranties
+of merchantability and fitness for a particular purpose. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+CONTRIBUTORS BE LIABLE for any direct, indirect, incidental, special, exemplary, or consequential damages,
+including but not limited to procurement of substitute goods or services; loss of use, data, or profits,
+or business interruption, however caused and on any theory of liability, whether in contract, strict
+liability, or tort (including negligence), arising in any way out of the use of this software, even if
+advised of the possibility of such damage.
+
+
+5. CONTACT INFORMATION
+
+Fraunhofer Institute for Integrated Circuits IIS
+Attention: Division Communication Systems
+Am Wolfsmantel 33
+91058 Erlangen, Germany
+ks-contracts@iis.fraunhofer.de
+
+----------------------------------------------------------------------------- */
+
+
+
+/**
+ * @brief	End to end test of SimpleNode with an emulated RFM69HW
+ *
+ * This host tool runs the complete node stack (FixedUplinkMac, PHY and Rfm69hw driver) on an
+ * emulated RFM69HW with a virtual timer. The bursts reconstructed from the register accesses are
+ * compared with an independent encoding of the same telegram using Phy::encode(): the transmitted
+ * bits, the frequencies and the start times. Additionally, the SPI traffic and the host CPU time
+ * of the driver are reported per burst. Finally, telegrams are transmitted with the precalculated
+ * schedule of Phy::encodeSchedule() and several telegrams are interleaved using the TxScheduler,
+ * including pairs of telegrams packed at the minimum distance accepted by the TxScheduler.
+ *
+ * Build, e.g.:
+ *   g++ -std=c++11 -O2 -I../.. Rfm69Emulation.cpp -o Rfm69Emulation
+ *
+ * Usage:
+ *   Rfm69Emulation [numTelegrams [seed]]
+ *
+ * The return value is 0 if all telegrams have been transmitted correctly.
+ *
+ * @file	Rfm69Emulation.cpp
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "TsUnb/RadioBurst.h"
+#include "TsUnb/FixedMac.h"
+#include "TsUnb/Phy.h"
+#include "TsUnb/SimpleNode.h"
+#include "TsUnb/TxScheduler.h"
+#include "Trx/Rfm69hw.h"
+#include "Host/Rfm69Emulator.h"
+
+using namespace TsUnbLib;
+
+//! Radio burst used for the test
+typedef TsUnb::RadioBurst<2, 2> RadioBurst_t;
+
+//! PHY used for the test (EU1)
+typedef TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG1, 3, RadioBurst_t> Phy_t;
+
+//! Emulated platform
+typedef Host::EmulatorCpu<> Cpu_t;
+
+//! Maximum MAC payload length used for the test
+#define EMULATION_MAX_PAYLOAD	200
+
+//! Number of interleaved telegrams
+#define EMULATION_NUM_INTERLEAVED	6
+
+//! Maximum number of radio bursts of the interleaved telegrams
+#define EMULATION_MAX_INTERLEAVED_BURSTS	400
+
+
+/**
+ * @brief Statistics of the test
+ */
+struct Statistics {
+	uint32_t numTelegrams;
+	uint32_t numBursts;
+	uint32_t numErrors;
+	double maxTimingError;
+	uint64_t numTransactions;
+	uint64_t numBytes;
+	double cpuSeconds;
+};
+
+
+/**
+ * @brief Checks the modes of the transmitter before and after a reconstructed burst
+ *
+ * The transmitter has to switch into TX mode from FS mode. Between two bursts it has to wait
+ * in the mode of the power policy, i.e. in standby mode only for short gaps, and in sleep mode
+ * after the last burst.
+ *
+ * @param	Emulated	Reconstructed bursts
+ * @param	burstIdx	Index of the burst
+ * @param	numBursts	Number of reconstructed bursts
+ *
+ * @return	true if the modes are valid
+ */
+static bool checkModes(const Host::EmulatedBurst* const Emulated, const uint16_t burstIdx, const uint16_t numBursts) {
+	typedef Trx::Rfm69PowerPolicy<Cpu_t::TS_UNB_SYMBOL_RATE_MULT> PowerPolicy_t;
+	const Host::EmulatedBurst& E = Emulated[burstIdx];
+	if (E.prevMode != TSUNB_HOST_RFM69_MODE_FS)
+		return false;
+	if (burstIdx + 1 == numBursts)
+		return E.nextMode == TSUNB_HOST_RFM69_MODE_SLEEP;
+
+	const int16_t gap = (int16_t)lround((double)(Emulated[burstIdx + 1].startTime - E.endTime) / Cpu_t::TS_UNB_BIT_DURATION)
+			- PowerPolicy_t::WAKE_SYMBOLS;
+	return E.nextMode == (PowerPolicy_t::useStandby(gap) ? TSUNB_HOST_RFM69_MODE_STDBY : TSUNB_HOST_RFM69_MODE_SLEEP);
+}
+
+
+/**
+ * @brief Compares the reconstructed bursts of a telegram with the expected bursts
+ *
+ * @param	Expected	Expected radio bursts
+ * @param	numBursts	Number of expected radio bursts
+ * @param	freqReg		Frequency f0 as transmitter register value
+ * @param	Emulated	Reconstructed bursts of the telegram
+ * @param	Stats		Statistics to be updated
+ */
+static void compareTelegram(const RadioBurst_t* const Expected, const uint16_t numBursts, const uint32_t freqReg,
+		const Host::EmulatedBurst* const Emulated, Statistics& Stats) {
+	// Ideal start time relative to the first burst in timer ticks
+	double idealStart = 0.0;
+	for (uint16_t i = 0; i < numBursts; ++i) {
+		const Host::EmulatedBurst& E = Emulated[i];
+		bool ok = E.frf == freqReg + Expected[i].getCarrierOffset() && E.numBits == RadioBurst_t::BURST_LENGTH;
+		for (uint16_t b = 0; b < RadioBurst_t::BURST_LENGTH && ok; ++b) {
+			const uint8_t expectedBit = (Expected[i].getBurst()[b / 8] >> (7 - b % 8)) & 1;
+			ok = E.getBit(b) == expectedBit;
+		}
+		if (!ok || !checkModes(Emulated, i, numBursts))
+			++Stats.numErrors;
+
+		const double timingError = fabs((double)(E.startTime - Emulated[0].startTime) - idealStart);
+		if (timingError > Stats.maxTimingError)
+			Stats.maxTimingError = timingError;
+		idealStart += Expected[i].get_T_RB() * (double)Cpu_t::TS_UNB_BIT_DURATION;
+
+		Stats.numTransactions += E.numTransactions;
+		Stats.numBytes += E.numBytes;
+	}
+	Stats.numBursts += numBursts;
+	++Stats.numTelegrams;
+}
+
+
+/**
+ * @brief Compares the reconstructed bursts of a transmission schedule with the expected bursts
+ *
+ * The start times have to match the schedule exactly. The 16 bit start ticks of the schedule are
+ * unwrapped, so that a missed timer event, which delays the transmission by a whole timer wrap,
+ * is detected as well.
+ *
+ * @param	Expected	Expected radio bursts of the schedule
+ * @param	Schedule	Transmission schedule
+ * @param	numBursts	Number of expected radio bursts
+ * @param	Emulated	Reconstructed bursts of the transmission
+ * @param	Stats		Statistics to be updated
+ */
+static void compareSchedule(const RadioBurst_t* const Expected, const TsUnb::TxScheduleEntry* const Schedule,
+		const uint16_t numBursts, const Host::EmulatedBurst* const Emulated, Statistics& Stats) {
+	// Start time relative to the first burst in timer ticks without wrap around
+	uint64_t expectedTicks = 0;
+	for (uint16_t i = 0; i < numBursts; ++i) {
+		const Host::EmulatedBurst& E = Emulated[i];
+		const uint32_t frf = ((uint32_t)Schedule[i].freqReg[0] << 16) | ((uint32_t)Schedule[i].freqReg[1] << 8) | Schedule[i].freqReg[2];
+		bool ok = E.frf == frf && E.numBits == RadioBurst_t::BURST_LENGTH;
+		for (uint16_t b = 0; b < RadioBurst_t::BURST_LENGTH && ok; ++b) {
+			ok = E.getBit(b) == ((Expected[i].getBurst()[b / 8] >> (7 - b % 8)) & 1);
+		}
+
+		if (i > 0)
+			expectedTicks += (uint16_t)(Schedule[i].startTick - Schedule[i - 1].startTick);
+		const uint64_t ticks = E.startTime - Emulated[0].startTime;
+		if (!ok || ticks != expectedTicks || !checkModes(Emulated, i, numBursts))
+			++Stats.numErrors;
+
+		const double timingError = fabs((double)ticks - (double)expectedTicks);
+		if (timingError > Stats.maxTimingError)
+			Stats.maxTimingError = timingError;
+
+		Stats.numTransactions += E.numTransactions;
+		Stats.numBytes += E.numBytes;
+	}
+	Stats.numBursts += numBursts;
+}
+
+
+/**
+ * @brief Transmits random telegrams with a SimpleNode and checks the reconstructed bursts
+ *
+ * In case of RETAINED the retained state of the transmitter is used and wake() is called before
+ * each telegram. A register of the emulated RFM69HW is changed every 16 telegrams, so that wake()
+ * has to detect the mismatch and to initialize the transmitter again.
+ *
+ * In case of NON_BLOCKING the telegrams are transmitted using beginSend() and the timer interrupt is
+ * emulated until poll() reports the end of the transmission. Every 16th telegram is cancelled during
+ * its first burst, which has to be completed, and then transmitted again.
+ *
+ * @param	numTelegrams	Number of telegrams
+ * @param	Random			Random generator
+ *
+ * @return	Statistics of the test
+ */
+template <bool SYNC_BURST, bool RETAINED = false, bool NON_BLOCKING = false>
+static Statistics runNode(const uint32_t numTelegrams, std::mt19937& Random) {
+	TsUnb::SimpleNode<TsUnb::FixedUplinkMac, Phy_t, Trx::Rfm69hw<Cpu_t, false, 10, RadioBurst_t>, SYNC_BURST> Node;
+	Statistics Stats = {0, 0, 0, 0.0, 0, 0, 0.0};
+
+	if (RETAINED)
+		Node.Tx.setRetainedState(true);
+	if (Node.init() != 0) {
+		++Stats.numErrors;
+		return Stats;
+	}
+	Node.Mac.setNetworkKey(0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c);
+	Node.Mac.setAddress(0x70, 0xB3, 0xD5, 0x67, 0x70, 0x00, 0x12, 0x34);
+
+	Host::Rfm69Emulator& Emulator = Node.Tx.Cpu.Emulator;
+	Phy_t Phy;
+
+	for (uint32_t t = 0; t < numTelegrams; ++t) {
+		uint8_t payload[EMULATION_MAX_PAYLOAD];
+		const uint16_t payloadLength = Random() % (EMULATION_MAX_PAYLOAD + 1);
+		for (uint16_t i = 0; i < payloadLength; ++i) {
+			payload[i] = (uint8_t)Random();
+		}
+		const bool priority = (Random() & 7) == 0;
+
+		// Independent encoding of the same telegram with a copy of the MAC
+		TsUnb::FixedUplinkMac RefMac = Node.Mac;
+		const uint16_t MPDU_length = RefMac.MPDU_Length(payloadLength);
+		std::vector<uint8_t> MPDU(MPDU_length);
+		RefMac.encode(MPDU.data(), payload, payloadLength, false, 0);
+		const uint8_t tsmaPattern = priority ? 6 : Phy.getTsmaPattern(RefMac.getCounter());
+
+		const uint16_t numDataBursts = Phy.numRadioBursts(MPDU_length);
+		std::vector<RadioBurst_t> Expected(numDataBursts + (SYNC_BURST ? 1 : 0));
+		RadioBurst_t* const DataBursts = &Expected[SYNC_BURST ? 1 : 0];
+		const uint32_t freqReg = Phy.encode(DataBursts, MPDU.data(), MPDU_length, tsmaPattern, TsUnb::FixedUplinkMac::MMODE);
+		if (SYNC_BURST) {
+			Phy.encodeSyncBurst(&Expected[0], tsmaPattern % TSUNBPHY_UNB_NUM_P, RefMac.getLsbShortAddress());
+		}
+
+		if (RETAINED) {
+			// Emulate the loss of the configuration, e.g. by a brown-out of the module
+			const bool corrupt = t % 16 == 15;
+			if (corrupt) {
+				uint8_t fdev[2] = {0x80 + 0x06, 0x52};
+				Emulator.spiTransfer(fdev, 2);
+			}
+			if (Node.Tx.wake() != (corrupt ? 1 : 0))
+				++Stats.numErrors;
+		}
+
+		Emulator.Bursts.clear();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		int16_t result;
+		if (NON_BLOCKING) {
+			if (t % 16 == 15) {
+				// Cancel the first attempt during the first burst
+				TsUnb::FixedUplinkMac SavedMac = Node.Mac;
+				result = Node.beginSend(payload, payloadLength, 0, priority);
+				while (result == 0 && Emulator.Bursts.empty() && Node.poll() == 1)
+					Node.Tx.Cpu.runTimerEvent();
+				Node.cancel();
+				if (Node.beginSend(payload, payloadLength, 0, priority) != -2)
+					++Stats.numErrors;
+				while (Node.poll() == 1)
+					Node.Tx.Cpu.runTimerEvent();
+				if (result != 0 || Node.poll() != -1 || Emulator.Bursts.size() != 1
+						|| Emulator.Bursts[0].numBits != RadioBurst_t::BURST_LENGTH)
+					++Stats.numErrors;
+				Node.Mac = SavedMac;
+				Emulator.Bursts.clear();
+			}
+			result = Node.beginSend(payload, payloadLength, 0, priority);
+			while (result == 0 && Node.poll() == 1)
+				Node.Tx.Cpu.runTimerEvent();
+			if (result == 0 && Node.poll() != 0)
+				++Stats.numErrors;
+		}
+		else {
+			result = Node.send(payload, payloadLength, 0, priority);
+		}
+		Stats.cpuSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (result != 0 || Emulator.Bursts.size() != Expected.size()) {
+			++Stats.numErrors;
+			continue;
+		}
+		compareTelegram(Expected.data(), (uint16_t)Expected.size(), freqReg, Emulator.Bursts.data(), Stats);
+
+		// One second between the telegrams
+		Node.Tx.Cpu.advanceTime(62500);
+	}
+	Stats.numErrors += Emulator.numFifoOverflows + Emulator.numFifoUnderruns + Node.Tx.Cpu.numTimerErrors;
+
+	return Stats;
+}
+
+
+/**
+ * @brief Transmits random telegrams with the schedule of Phy::encodeSchedule() and checks the reconstructed bursts
+ *
+ * The schedule of each telegram has to be identical to the schedule of the TxScheduler for this
+ * telegram only. The reconstructed bursts are compared with the encoded bursts, the start times
+ * have to match the start times of the schedule without wrap around exactly.
+ *
+ * @param	numTelegrams	Number of telegrams
+ * @param	Random			Random number generator
+ *
+ * @return	Statistics of the test
+ */
+static Statistics runSchedule(const uint32_t numTelegrams, std::mt19937& Random) {
+	typedef Trx::Rfm69hw<Cpu_t, false, 10, RadioBurst_t> Trx_t;
+	static TsUnb::TxScheduler<RadioBurst_t, EMULATION_MAX_INTERLEAVED_BURSTS, Trx_t::SCHEDULE_GUARD_SYMBOLS> Scheduler(Cpu_t::TS_UNB_BIT_DURATION_Q16);
+	Statistics Stats = {0, 0, 0, 0.0, 0, 0, 0.0};
+	Trx_t Tx;
+	Phy_t Phy;
+
+	if (Tx.init() != 0) {
+		++Stats.numErrors;
+		return Stats;
+	}
+	Host::Rfm69Emulator& Emulator = Tx.Cpu.Emulator;
+
+	for (uint32_t t = 0; t < numTelegrams; ++t) {
+		const uint16_t MPDU_length = Random() % (EMULATION_MAX_PAYLOAD + 1);
+		std::vector<uint8_t> MPDU(MPDU_length + 1);
+		for (uint16_t i = 0; i < MPDU_length; ++i) {
+			MPDU[i] = (uint8_t)Random();
+		}
+		const uint16_t numBursts = Phy.numRadioBursts(MPDU_length);
+		std::vector<RadioBurst_t> Bursts(numBursts);
+		const uint32_t freqReg = Phy.encode(Bursts.data(), MPDU.data(), MPDU_length, Random() % TSUNBPHY_UNB_NUM_P, TsUnb::FixedUplinkMac::MMODE);
+		std::vector<TsUnb::TxScheduleEntry> Schedule(numBursts);
+		Phy.encodeSchedule(Schedule.data(), Bursts.data(), numBursts, freqReg, Cpu_t::TS_UNB_BIT_DURATION_Q16);
+
+		// The TxScheduler has to round the start times identically
+		Scheduler.clear();
+		if (Scheduler.addTelegram(Bursts.data(), numBursts, freqReg, 0) != 0 || Scheduler.getNumBursts() != numBursts) {
+			++Stats.numErrors;
+			continue;
+		}
+		for (uint16_t i = 0; i < numBursts; ++i) {
+			const TsUnb::TxScheduleEntry& A = Schedule[i];
+			const TsUnb::TxScheduleEntry& B = Scheduler.getSchedule()[i];
+			if (A.startTick != B.startTick || A.freqReg[0] != B.freqReg[0] || A.freqReg[1] != B.freqReg[1] || A.freqReg[2] != B.freqReg[2]
+					|| memcmp(Bursts[i].getBurst(), Scheduler.getBursts()[i].getBurst(), RadioBurst_t::BURST_LENGTH_BYTES) != 0)
+				++Stats.numErrors;
+		}
+
+		Emulator.Bursts.clear();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const int16_t result = Tx.transmit(Bursts.data(), Schedule.data(), numBursts);
+		Stats.cpuSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (result != 0 || Emulator.Bursts.size() != numBursts) {
+			++Stats.numErrors;
+			continue;
+		}
+		compareTelegram(Bursts.data(), numBursts, freqReg, Emulator.Bursts.data(), Stats);
+
+		// Start times without wrap around, rounded like Phy::encodeSchedule()
+		uint32_t startSymbol = 0;
+		for (uint16_t i = 0; i < numBursts; ++i) {
+			const uint64_t expectedTicks = ((uint64_t)startSymbol * Cpu_t::TS_UNB_BIT_DURATION_Q16 + 0x8000u) >> 16;
+			if (Emulator.Bursts[i].startTime - Emulator.Bursts[0].startTime != expectedTicks)
+				++Stats.numErrors;
+			startSymbol += Bursts[i].get_T_RB();
+		}
+
+		Tx.Cpu.advanceTime(62500);
+	}
+	Stats.numErrors += Emulator.numFifoOverflows + Emulator.numFifoUnderruns + Tx.Cpu.numTimerErrors;
+
+	return Stats;
+}
+
+
+/**
+ * @brief Interleaves random telegrams of different addresses and checks the reconstructed bursts
+ *
+ * Each telegram is placed at the earliest start offset without conflicts, telegrams without such
+ * an offset are rejected. The reconstructed bursts are compared with the merged schedule, i.e. the
+ * bits, the frequencies and the start times.
+ *
+ * @param	numTelegrams	Number of telegrams
+ * @param	Random			Random number generator
+ *
+ * @return	Statistics of the test
+ */
+static Statistics runInterleaved(const uint32_t numTelegrams, std::mt19937& Random) {
+	typedef Trx::Rfm69hw<Cpu_t, false, 10, RadioBurst_t> Trx_t;
+	static TsUnb::TxScheduler<RadioBurst_t, EMULATION_MAX_INTERLEAVED_BURSTS, Trx_t::SCHEDULE_GUARD_SYMBOLS> Scheduler(Cpu_t::TS_UNB_BIT_DURATION_Q16);
+	Statistics Stats = {0, 0, 0, 0.0, 0, 0, 0.0};
+	Trx_t Tx;
+	Phy_t Phy;
+
+	if (Tx.init() != 0) {
+		++Stats.numErrors;
+		return Stats;
+	}
+	Host::Rfm69Emulator& Emulator = Tx.Cpu.Emulator;
+
+	uint32_t maxOffset = 0;
+	uint32_t numRejected = 0;
+	for (uint32_t t = 0; t < numTelegrams; t += EMULATION_NUM_INTERLEAVED) {
+		Scheduler.clear();
+
+		for (uint8_t i = 0; i < EMULATION_NUM_INTERLEAVED; ++i) {
+			TsUnb::FixedUplinkMac Mac;
+			Mac.setNetworkKey(0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c);
+			Mac.setAddress(0x70, 0xB3, 0xD5, 0x67, 0x70, 0x00, 0x12, i);
+
+			uint8_t payload[EMULATION_MAX_PAYLOAD];
+			const uint16_t payloadLength = Random() % 21;
+			for (uint16_t b = 0; b < payloadLength; ++b) {
+				payload[b] = (uint8_t)Random();
+			}
+			const uint16_t MPDU_length = Mac.MPDU_Length(payloadLength);
+			std::vector<uint8_t> MPDU(MPDU_length);
+			Mac.encode(MPDU.data(), payload, payloadLength, false, 0);
+			std::vector<RadioBurst_t> Bursts(Phy.numRadioBursts(MPDU_length));
+			const uint32_t freqReg = Phy.encode(Bursts.data(), MPDU.data(), MPDU_length, Phy.getTsmaPattern(Mac.getCounter()), TsUnb::FixedUplinkMac::MMODE);
+
+			const int32_t offset = Scheduler.findOffset(Bursts.data(), (uint16_t)Bursts.size(), 0, 1200);
+			if (offset < 0 || Scheduler.addTelegram(Bursts.data(), (uint16_t)Bursts.size(), freqReg, (uint32_t)offset) != 0) {
+				++numRejected;
+				continue;
+			}
+			if ((uint32_t)offset > maxOffset)
+				maxOffset = (uint32_t)offset;
+			++Stats.numTelegrams;
+		}
+
+		const uint16_t numBursts = Scheduler.getNumBursts();
+		const RadioBurst_t* const Expected = Scheduler.getBursts();
+		const TsUnb::TxScheduleEntry* const Schedule = Scheduler.getSchedule();
+		Emulator.Bursts.clear();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const int16_t result = Tx.transmit(Expected, Schedule, numBursts);
+		Stats.cpuSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (result != 0 || Emulator.Bursts.size() != numBursts) {
+			++Stats.numErrors;
+			continue;
+		}
+		compareSchedule(Expected, Schedule, numBursts, Emulator.Bursts.data(), Stats);
+		Tx.Cpu.advanceTime(62500);
+	}
+	Stats.numErrors += Emulator.numFifoOverflows + Emulator.numFifoUnderruns + Tx.Cpu.numTimerErrors;
+	printf("Interleaved  %u telegrams per transmission, rejected %u, maximum start offset %u symbols\n",
+			EMULATION_NUM_INTERLEAVED, numRejected, maxOffset);
+
+	return Stats;
+}
+
+
+/**
+ * @brief Packs pairs of random telegrams as close as possible and checks the reconstructed bursts
+ *
+ * Both telegrams use the TSMA pattern 0. The second telegram is placed at the smallest start
+ * offset accepted by the TxScheduler, i.e. two bursts start at the minimum distance, and the
+ * transmission has to match the schedule exactly.
+ *
+ * Additionally, the second telegram is placed at the start offset of 509 symbols. Then the wake up
+ * before a burst of the second telegram coincides with the end of a burst of the first telegram.
+ * The TxScheduler has to reject this offset. A schedule with this offset, which is created with a
+ * guard of 2 symbols only, has to be rejected by the transmitter, since the timer event of the
+ * wake up would be missed.
+ *
+ * @param	numTelegrams	Number of telegrams
+ * @param	Random			Random number generator
+ *
+ * @return	Statistics of the test
+ */
+static Statistics runPacked(const uint32_t numTelegrams, std::mt19937& Random) {
+	typedef Trx::Rfm69hw<Cpu_t, false, 10, RadioBurst_t> Trx_t;
+	static TsUnb::TxScheduler<RadioBurst_t, EMULATION_MAX_INTERLEAVED_BURSTS, Trx_t::SCHEDULE_GUARD_SYMBOLS> Scheduler(Cpu_t::TS_UNB_BIT_DURATION_Q16);
+	static TsUnb::TxScheduler<RadioBurst_t, EMULATION_MAX_INTERLEAVED_BURSTS, 2> ShortGuardScheduler(Cpu_t::TS_UNB_BIT_DURATION_Q16);
+	const uint32_t conflictOffset = 509;
+	Statistics Stats = {0, 0, 0, 0.0, 0, 0, 0.0};
+	Trx_t Tx;
+	Phy_t Phy;
+
+	if (Tx.init() != 0) {
+		++Stats.numErrors;
+		return Stats;
+	}
+	Host::Rfm69Emulator& Emulator = Tx.Cpu.Emulator;
+
+	uint32_t minOffset = UINT32_MAX;
+	for (uint32_t t = 0; t < numTelegrams; t += 2) {
+		const uint16_t MPDU_length = 1 + Random() % 21;
+		const uint16_t numTelegramBursts = Phy.numRadioBursts(MPDU_length);
+		std::vector<RadioBurst_t> Bursts[2];
+		uint32_t freqReg[2];
+		for (uint8_t i = 0; i < 2; ++i) {
+			std::vector<uint8_t> MPDU(MPDU_length + 1);
+			for (uint16_t b = 0; b < MPDU_length; ++b) {
+				MPDU[b] = (uint8_t)Random();
+			}
+			Bursts[i].resize(numTelegramBursts);
+			freqReg[i] = Phy.encode(Bursts[i].data(), MPDU.data(), MPDU_length, 0, TsUnb::FixedUplinkMac::MMODE);
+		}
+
+		// The wake up before a burst must not coincide with the end of the previous burst
+		Scheduler.clear();
+		ShortGuardScheduler.clear();
+		if (Scheduler.addTelegram(Bursts[0].data(), numTelegramBursts, freqReg[0], 0) != 0
+				|| Scheduler.addTelegram(Bursts[1].data(), numTelegramBursts, freqReg[1], conflictOffset) != -2
+				|| ShortGuardScheduler.addTelegram(Bursts[0].data(), numTelegramBursts, freqReg[0], 0) != 0
+				|| ShortGuardScheduler.addTelegram(Bursts[1].data(), numTelegramBursts, freqReg[1], conflictOffset) != 0)
+			++Stats.numErrors;
+		Emulator.Bursts.clear();
+		if (Tx.transmit(ShortGuardScheduler.getBursts(), ShortGuardScheduler.getSchedule(), ShortGuardScheduler.getNumBursts()) != -2
+				|| !Emulator.Bursts.empty())
+			++Stats.numErrors;
+
+		// Second telegram at the minimum distance
+		const int32_t offset = Scheduler.findOffset(Bursts[1].data(), numTelegramBursts, 1, 1200);
+		if (offset < 0 || Scheduler.addTelegram(Bursts[1].data(), numTelegramBursts, freqReg[1], (uint32_t)offset) != 0) {
+			++Stats.numErrors;
+			continue;
+		}
+		if ((uint32_t)offset < minOffset)
+			minOffset = (uint32_t)offset;
+		Stats.numTelegrams += 2;
+
+		const uint16_t numBursts = Scheduler.getNumBursts();
+		Emulator.Bursts.clear();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const int16_t result = Tx.transmit(Scheduler.getBursts(), Scheduler.getSchedule(), numBursts);
+		Stats.cpuSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if (result != 0 || Emulator.Bursts.size() != numBursts) {
+			++Stats.numErrors;
+			continue;
+		}
+		compareSchedule(Scheduler.getBursts(), Scheduler.getSchedule(), numBursts, Emulator.Bursts.data(), Stats);
+		Tx.Cpu.advanceTime(62500);
+	}
+	Stats.numErrors += Emulator.numFifoOverflows + Emulator.numFifoUnderruns + Tx.Cpu.numTimerErrors;
+	printf("Packed       2 telegrams per transmission, minimum start offset %u symbols\n", minOffset);
+
+	return Stats;
+}
+
+
+/**
+ * @brief Prints the statistics of a test
+ */
+static void printStatistics(const char* const name, const Statistics& Stats) {
+	const double bursts = Stats.numBursts ? Stats.numBursts : 1;
+	printf("%-12s telegrams %u  bursts %u  errors %u  max timing error %.1fus  SPI per burst %.2f transactions %.2f bytes  host CPU %.0fns per burst\n",
+			name, Stats.numTelegrams, Stats.numBursts, Stats.numErrors,
+			Stats.maxTimingError * 1.0e6 / 62500.0,
+			Stats.numTransactions / bursts, Stats.numBytes / bursts,
+			Stats.cpuSeconds * 1.0e9 / bursts);
+}
+
+
+int main(int argc, char** argv) {
+	const uint32_t numTelegrams = argc > 1 ? (uint32_t)atoi(argv[1]) : 200;
+	std::mt19937 Random(argc > 2 ? (uint32_t)atoi(argv[2]) : 1);
+
+	const Statistics Stats = runNode<false>(numTelegrams, Random);
+	printStatistics("SimpleNode", Stats);
+
+	const Statistics SyncStats = runNode<true>(numTelegrams, Random);
+	printStatistics("Sync burst", SyncStats);
+
+	const Statistics ScheduleStats = runSchedule(numTelegrams, Random);
+	printStatistics("Schedule", ScheduleStats);
+
+	const Statistics InterleavedStats = runInterleaved(numTelegrams, Random);
+	printStatistics("Interleaved", InterleavedStats);
+
+	const Statistics PackedStats = runPacked(numTelegrams, Random);
+	printStatistics("Packed", PackedStats);
+
+	const Statistics RetainedStats = runNode<false, true>(numTelegrams, Random);
+	printStatistics("Retained", RetainedStats);
+
+	const Statistics NonBlockingStats = runNode<false, false, true>(numTelegrams, Random);
+	printStatistics("Non-blocking", NonBlockingStats);
+
+	const Statistics SyncNonBlockingStats = runNode<true, false, true>(numTelegrams, Random);
+	printStatistics("Sync nonblk", SyncNonBlockingStats);
+
+	return Stats.numErrors + SyncStats.numErrors + ScheduleStats.numErrors + InterleavedStats.numErrors + PackedStats.numErrors + RetainedStats.numErrors +
+			NonBlockingStats.numErrors + SyncNonBlockingStats.numErrors ? 1 : 0;
+}
@@ -87,24 +87,24 @@ ks-contracts@iis.fraunhofer.de
 namespace TsUnbLib {
 namespace Arduino {
 
-//! This is an internal counter for creating timer interrupts to create the requested bit-rate
-volatile int32_t TsUnbTimerOverflows;
-
-//! Integer part of the Timer Reload value
-volatile uint16_t TsUnbTimerReload;
-
-//! Threshold to generate fractional Timer Reload values
-volatile uint8_t TsUnbFractionalThreshold;
-
 //! Flag to indicate a timer match
 volatile bool TsUnbTimerFlag; 
 
+//! Function called by the timer interrupt
+void (* volatile TsUnbTimerCallback)(void*);
+
+//! Context passed to TsUnbTimerCallback
+void* volatile TsUnbTimerContext;
+
 /**
  * @brief Interrupt function for compare match of timer to set TimerFlag
  */
 ISR (TIMER1_COMPA_vect) {
 	TsUnbTimerFlag = true;
 
+	if (TsUnbTimerCallback)
+		TsUnbTimerCallback(TsUnbTimerContext);
+
 	return;
 }
 
@@ -93,10 +93,17 @@ ks-contracts@iis.fraunhofer.de
 #include <avr/sleep.h>
 #include <avr/power.h>
 #include <avr/wdt.h>
+#include <util/atomic.h>
 #include <Arduino.h>
 #include <SPI.h>
 
 #include "ArduinoUtils.h"
+
+//! RAM budget of a TS-UNB node, half of the internal SRAM
+#ifndef TSUNB_NODE_RAM_BUDGET
+#define TSUNB_NODE_RAM_BUDGET	((RAMEND - RAMSTART + 1) / 2)
+#endif
+
 #include "../TsUnb/RadioBurst.h"
 #include "../TsUnb/FixedMac.h"
 #include "../TsUnb/Phy.h"
@@ -107,11 +114,19 @@ namespace Arduino {
 //! Flag to indicate trigger of time, set by timer interrupt
 extern volatile bool TsUnbTimerFlag;
 
+//! Function called by the timer interrupt, e.g. for interrupt driven transmissions
+extern void (* volatile TsUnbTimerCallback)(void*);
+
+//! Context passed to TsUnbTimerCallback
+extern void* volatile TsUnbTimerContext;
+
 /**
  * @brief Platform dependent TS-UNB implementation for ATMega328p based Arduino systems.
  *
  * This class implents all plaform dependent methods for TS-UNB.
  * It mainly offer SPI communication and a timer to generate the TS-UNB symbol clock.
+ * The timer methods restore the previous interrupt state, i.e. they can be called from
+ * the timer callback without enabling nested interrupts.
  *
  * @param CS_PIN              SPI chip select pin (default is 8)
  * @param SYMBOL_RATE_MULT    TS-UNB, symbol rate in multiples of 49.591064453125, set for 48 for 2380.371sym/s and 8 for 396.729sym/s. For higher rates the clock divider of the timer may have to be adjusted.
@@ -125,6 +140,17 @@ template <uint8_t CS_PIN = 8,
 		int16_t TIMING_OFFSET_PPM = 0,
 		bool CS_PULL_UP = true, bool SPI_INIT = true, bool WDT_RESET = true>
 class ArduinoTsUnb {
+	//! Numerator of the bit duration in timer 1 counts, i.e. F_CPU / 256 * 4096 / (203125 * SYMBOL_RATE_MULT) * (1 + 1e-6 * TIMING_OFFSET_PPM)
+	static constexpr uint64_t BIT_DURATION_NUM = (uint64_t)F_CPU * (uint64_t)(1000000L + TIMING_OFFSET_PPM);
+
+	//! Denominator of the bit duration in timer 1 counts
+	static constexpr uint64_t BIT_DURATION_DEN = 203125ULL * SYMBOL_RATE_MULT * 62500ULL;
+
+	//! Remainder of the integer part of the bit duration shifted by 16 bits for the long division
+	static constexpr uint64_t BIT_DURATION_REM = (BIT_DURATION_NUM % BIT_DURATION_DEN) << 16;
+
+	static_assert(BIT_DURATION_DEN < (1ULL << 47), "The symbol rate is too high for the calculation of the bit duration");
+
 public:
 	ArduinoTsUnb() {
 	}
@@ -132,6 +158,11 @@ public:
 	~ArduinoTsUnb() {
 	}
 
+	/**
+	 * @brief TS-UNB symbol rate in multiples of 49.591064453125, e.g. for the power policy of the transmitter
+	 */
+	static constexpr uint16_t TS_UNB_SYMBOL_RATE_MULT = SYMBOL_RATE_MULT;
+
 	/**
 	 * @brief Bit duration in timer 1 counts
 	 *
@@ -141,30 +172,49 @@ public:
 	 */
 	static constexpr float TS_UNB_BIT_DURATION = (double)F_CPU / 256.0 / (49.591064453125 * (double)SYMBOL_RATE_MULT) * (1.0 + 1.0e-6 * TIMING_OFFSET_PPM);
 
+	/**
+	 * @brief Bit duration in timer 1 counts as Q16.32 fixed point value
+	 *
+	 * This value is used by addTimerDelay(). It is calculated by an integer long division in
+	 * steps of 16 bits, since double is a 32 bit float for avr-gcc. The rounding error of
+	 * 2^-33 counts per symbol results in less than 10^-4 counts even after 10^5 symbols.
+	 */
+	static constexpr uint64_t TS_UNB_BIT_DURATION_Q32 = ((BIT_DURATION_NUM / BIT_DURATION_DEN) << 32)
+			+ ((BIT_DURATION_REM / BIT_DURATION_DEN) << 16)
+			+ ((((BIT_DURATION_REM % BIT_DURATION_DEN) << 16) + BIT_DURATION_DEN / 2) / BIT_DURATION_DEN);
+
+	/**
+	 * @brief Bit duration in timer 1 counts as Q16.16 fixed point value
+	 *
+	 * This value is used to precalculate the timer compare values, e.g. for transmission schedules.
+	 */
+	static constexpr uint32_t TS_UNB_BIT_DURATION_Q16 = (uint32_t)((TS_UNB_BIT_DURATION_Q32 + 0x8000u) >> 16);
+
 
 	/**
 	 * @brief Init the timer
 	 */
 	void initTimer() {
-		cli();
-		preciseTsUnbTimer = 0;
-		TCCR1A = 0;		// No PWM
-		TCCR1B = 0;		// No Timer
-		TCNT1 = 0;
-		OCR1A = OCR1B = 0;
-		sei();
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			preciseTsUnbTimer = 0;
+			preciseTsUnbTimerFrac = 0;
+			TCCR1A = 0;		// No PWM
+			TCCR1B = 0;		// No Timer
+			TCNT1 = 0;
+			OCR1A = OCR1B = 0;
+		}
 	}
 
 	/**
 	 * @brief Start the timer
 	 */
 	void startTimer() {
-		cli();
-		TsUnbTimerFlag = false;
-		TCCR1A = 0;
-		TIMSK1 |= (1 << OCIE1A);	// Timer match A Interrupt 
-		TCCR1B |= (1 << CS12);		// Prescaler 1/256
-		sei();
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			TsUnbTimerFlag = false;
+			TCCR1A = 0;
+			TIMSK1 |= (1 << OCIE1A);	// Timer match A Interrupt 
+			TCCR1B |= (1 << CS12);		// Prescaler 1/256
+		}
 	}
 
 
@@ -173,36 +223,108 @@ public:
 	 * @brief Stop the timer to save energy
 	 */
 	void stopTimer() {
-		cli();
-		TCCR1A = 0;
-		TIMSK1 = 0;
-		TCNT1 = 0;
-		sei();
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			TCCR1A = 0;
+			TIMSK1 = 0;
+			TCNT1 = 0;
+		}
 	}
 
 	/**
 	 * @brief Add the counter compare value for the next interrupt
 	 *
-	 * @param count Delay in TX symbols
+	 * The precise timer state is a Q16.32 fixed point value, which is split into a Q16.16 part
+	 * and 16 additional fractional bits. It only requires integer multiplications and wraps
+	 * around together with the 16 bit timer, i.e. there is no drift over long telegrams.
+	 * The carry of the fractional bits assumes a non-negative delay.
+	 *
+	 * @param count Delay in TX symbols (0 ... 65535), must not be negative
 	 */
 	void addTimerDelay(const int32_t count) {
-		preciseTsUnbTimer += TS_UNB_BIT_DURATION * count;
+		const uint32_t frac = (uint32_t)count * (uint16_t)TS_UNB_BIT_DURATION_Q32 + preciseTsUnbTimerFrac;
+		preciseTsUnbTimerFrac = (uint16_t)frac;
+		preciseTsUnbTimer += (uint32_t)count * (uint32_t)(TS_UNB_BIT_DURATION_Q32 >> 16) + (frac >> 16);
 
 		// Round to precise timer state to neared integer value and calculate value for compare match register 
-		const uint16_t timerCompareMatch = (uint32_t)((int32_t)(preciseTsUnbTimer + 0.5f)) & 0xFFFF;
-		cli();
-		OCR1A = timerCompareMatch;
-		sei();
-
-		// Clip to range between 0 and 655356
-		while (preciseTsUnbTimer >= 0x10000)
-			preciseTsUnbTimer -= 0x10000;
+		const uint16_t timerCompareMatch = (uint16_t)((preciseTsUnbTimer + 0x8000u) >> 16);
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			OCR1A = timerCompareMatch;
+		}
+	}
+
+	/**
+	 * @brief Set the absolute counter compare value for the next interrupt
+	 *
+	 * This method directly sets the compare value without any calculations, e.g.
+	 * for precalculated transmission schedules. It does not update the state used
+	 * by addTimerDelay().
+	 *
+	 * @param timerCompareMatch Timer value of the next interrupt in timer 1 counts
+	 */
+	void setTimerCompare(const uint16_t timerCompareMatch) {
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			OCR1A = timerCompareMatch;
+		}
+	}
+
+	/**
+	 * @brief Returns the current value of timer 1, e.g. for the timing audit
+	 */
+	uint16_t getTimerCount() const {
+		uint16_t count;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			count = TCNT1;
+		}
+		return count;
+	}
+
+	/**
+	 * @brief Returns the current compare value of timer 1, e.g. for the timing audit
+	 */
+	uint16_t getTimerCompare() const {
+		uint16_t compare;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			compare = OCR1A;
+		}
+		return compare;
+	}
+
+	/**
+	 * @brief Set the function called by the timer interrupt
+	 *
+	 * The \p callback is called with the \p context at every compare match of timer 1,
+	 * i.e. it is executed within the interrupt. A null pointer disables the callback.
+	 *
+	 * @param callback Function called by the timer interrupt
+	 * @param context  Context passed to the \p callback
+	 */
+	void setTimerCallback(void (* const callback)(void*), void* const context) {
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			TsUnbTimerCallback = callback;
+			TsUnbTimerContext = context;
+		}
 	}
 
 	/**
 	 * @brief Wait until the timer values expires
+	 *
+	 * The CPU waits in the idle mode, which is the deepest sleep mode with a running timer 1.
+	 * In case of \p lowPower the ADC, the analog comparator and the TWI are switched off
+	 * during the wait to reduce the idle current. Their state is restored afterwards, which
+	 * delays the return by a few cycles.
+	 *
+	 * @param lowPower  Switch off the unused peripherals during the wait
 	 */
-	void waitTimer() const {
+	void waitTimer(const bool lowPower = false) const {
+		const uint8_t adcsra = ADCSRA;
+		const uint8_t acsr = ACSR;
+		const uint8_t prr = PRR;
+		if (lowPower) {
+			ADCSRA = adcsra & ~_BV(ADEN);
+			ACSR = acsr | _BV(ACD);
+			PRR = prr | _BV(PRADC) | _BV(PRTWI);
+		}
+
 		do {
 			if (TsUnbTimerFlag)
 				break;
@@ -212,6 +334,11 @@ public:
 		} while (true);
 		TsUnbTimerFlag = false;
 
+		if (lowPower) {
+			PRR = prr;
+			ACSR = acsr;
+			ADCSRA = adcsra;
+		}
 	}
 
 	/**
@@ -258,6 +385,29 @@ public:
 		SPI.endTransaction();
 	}
 
+	/**
+	 * @brief Writes multiple bytes to a single register address within one SPI transaction
+	 *
+	 * The address byte and all data bytes are sent while the slave select pin is kept low,
+	 * e.g. to fill the FIFO of the transceiver without releasing the bus after every byte.
+	 *
+	 * @param address  Register address byte including the write flag
+	 * @param dataOut  Bytes to be transmitted
+	 * @param numBytes Number of data bytes to be transmitted
+	 */
+	void spiSendBurst(const uint8_t address, const uint8_t* const dataOut, const uint8_t numBytes) {
+		SPI.beginTransaction(SPISettings(4000000, MSBFIRST, SPI_MODE0));
+		digitalWrite(CS_PIN, LOW); 
+
+		SPI.transfer(address);
+		for(uint8_t i = 0; i < numBytes; ++i) {
+			SPI.transfer(dataOut[i]);
+		}
+		digitalWrite(CS_PIN, HIGH); 
+
+		SPI.endTransaction();
+	}
+
 	/**
 	 * @brief Sends multiple and receives bytes using SPI and sets the slave select pin accordingly
 	 *
@@ -288,8 +438,11 @@ public:
 	}
 
 
-	//! Precise state of TsUnb timer
-	float preciseTsUnbTimer;
+	//! Precise state of TsUnb timer in timer 1 counts as Q16.16 fixed point value
+	uint32_t preciseTsUnbTimer;
+
+	//! Additional fractional bits of the precise state of TsUnb timer
+	uint16_t preciseTsUnbTimerFrac;
 
 };
 
@@ -87,46 +87,49 @@ ks-contracts@iis.fraunhofer.de
 
 namespace TsUnbLib {
 namespace Arduino {
+
+// The template parameter MAX_PAYLOAD sets the maximum payload length in bytes, smaller values
+// reduce the RAM of the node, e.g. TsUnb_EU1_Rfm69w_t<8, 16> for up to 16 bytes.
 	
 /////////////////////////////////
 // Configuration for the RFM69w
 /////////////////////////////////
 
 //! RFM69hw in EU0 configuration, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU0_Rfm69w_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14224261, 14224261, 39, 39, TsUnb::TsUnb_UPG1, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU1 configuration, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU1_Rfm69w_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG1, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU2 configuration (includes bugfix wrt. V 1.1.1 of the TS-UNB specification, correct are 867.625MHz and 866.825MHz), no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU2_Rfm69w_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14215168, 14202061, 468, 39, TsUnb::TsUnb_UPG1, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU0 configuration, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU0_LowLatency_Rfm69w_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14224261, 14224261, 39, 39, TsUnb::TsUnb_UPG3, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU1 configuration with Low Latency Uplink Pattern Group 3, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU1_LowLatency_Rfm69w_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG3, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU2 configuration with Low Latency Uplink Pattern Group 3, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU2_LowLatency_Rfm69w_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14215168, 14202061, 468, 39, TsUnb::TsUnb_UPG3, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, false, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 
 
@@ -135,40 +138,40 @@ using TsUnb_EU2_LowLatency_Rfm69w_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac,
 /////////////////////////////////
 
 //! RFM69hw in EU0 configuration, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU0_Rfm69hw_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14224261, 14224261, 39, 39, TsUnb::TsUnb_UPG1, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU1 configuration, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU1_Rfm69hw_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG1, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU2 configuration (includes bugfix wrt. V 1.1.1 of the TS-UNB specification, correct are 867.625MHz and 866.825MHz), no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU2_Rfm69hw_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14215168, 14202061, 468, 39, TsUnb::TsUnb_UPG1, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU0 configuration, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU0_LowLatency_Rfm69hw_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14224261, 14224261, 39, 39, TsUnb::TsUnb_UPG3, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU1 configuration with Low Latency Uplink Pattern Group 3, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU1_LowLatency_Rfm69hw_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14224261, 14222623, 39, 39, TsUnb::TsUnb_UPG3, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 //! RFM69hw in EU2 configuration with Low Latency Uplink Pattern Group 3, no Sync Burst
-template<uint8_t CS_PIN = 8>
+template<uint8_t CS_PIN = 8, uint16_t MAX_PAYLOAD = TSUNBPHY_MAX_PSDU_LENGTH - FIXEDMAC_MAX_OVERHEAD>
 using TsUnb_EU2_LowLatency_Rfm69hw_t = TsUnb::SimpleNode<TsUnb::FixedUplinkMac, 
 		TsUnb::Phy<14215168, 14202061, 468, 39, TsUnb::TsUnb_UPG3, 3, TsUnb::RadioBurst <2,2> >,
-		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false>;
+		Trx::Rfm69hw<ArduinoTsUnb<CS_PIN, 48, XTAL_PPM_OFFSET>, true, 10, TsUnb::RadioBurst <2,2> >, false, MAX_PAYLOAD>;
 
 
 